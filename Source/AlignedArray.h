@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    AlignedArray.h
+    Created: 16 Oct 2026 9:40:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ Heap array whose first element sits on a 64 byte boundary (one cache line, wide enough for any
+ SIMD register width), so tables used in vector loops never start mid-line.
+ */
+template <typename Type>
+class AlignedArray {
+public:
+    static constexpr size_t alignment = 64;
+
+    AlignedArray() { }
+
+    /** Allocates the array, don't call this from the audio thread. */
+    void allocate(const int newNumElements, const bool clearMemory)
+    {
+        storage.allocate((size_t)newNumElements * sizeof(Type) + alignment, clearMemory);
+
+        const auto address = reinterpret_cast<uintptr_t>(storage.get());
+        data = reinterpret_cast<Type*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        numElements = newNumElements;
+    }
+
+    Type* get() noexcept { return data; }
+    const Type* get() const noexcept { return data; }
+
+    Type& operator[](const int index) noexcept { return data[index]; }
+    const Type& operator[](const int index) const noexcept { return data[index]; }
+
+    int size() const noexcept { return numElements; }
+
+private:
+    HeapBlock<char> storage;
+    Type* data = nullptr;
+    int numElements = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(AlignedArray)
+};
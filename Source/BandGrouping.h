@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    BandGrouping.h
+    Created: 18 Oct 2026 10:14:00am
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+enum class BandScale {
+    /** no grouping, every bin is processed on its own */
+    none,
+    /** critical bands, uniformly spaced on Traunmueller's Bark scale (default 24 bands) */
+    bark,
+    /** uniformly spaced on Glasberg and Moore's ERB-rate scale (default 40 bands) */
+    erb,
+    /** fractions of an octave around 1 kHz (default 3 bands per octave) */
+    fractionalOctave
+};
+
+/**
+ Maps the bins of a spectrum onto perceptual bands and back. The bands are centred on points spaced
+ uniformly on the chosen scale, and every bin lies between two neighbouring centres, with triangular
+ weights. So the bin/band matrix has exactly two entries per bin and is stored as the lower band and
+ the weight of the upper one for every bin, which works in both directions:
+ - sumBins() collects per-bin values (e.g. powers) into the bands
+ - spreadBands() interpolates per-band values (e.g. gains) back to the bins
+ Band centres closer than one bin are dropped, so the actual number of bands may be lower than requested.
+ */
+class BandGrouping {
+public:
+    BandGrouping() { }
+
+    /** Builds the mapping, don't call this from the audio thread.
+     @param resolution number of bands (bark, erb) or bands per octave (fractionalOctave), 0 for the default
+     */
+    void create(const BandScale scale, const int resolution, const int fftSize, const double sampleRate)
+    {
+        jassert(scale != BandScale::none);
+
+        numBins = fftSize / 2 + 1;
+        const double binWidth = sampleRate / fftSize;
+        const double nyquist = 0.5 * sampleRate;
+
+        std::vector<double> centres;
+        if (scale == BandScale::fractionalOctave) {
+            const int bandsPerOctave = resolution > 0 ? resolution : 3;
+            for (int k = (int)std::floor(bandsPerOctave * std::log2(binWidth / 1000.0)); ; ++k) {
+                const double centre = 1000.0 * std::pow(2.0, (double)k / bandsPerOctave);
+                if (centre >= nyquist)
+                    break;
+                centres.push_back(centre);
+            }
+            centres.push_back(nyquist);
+        }
+        else {
+            const int numRequested = jmax(2, resolution > 0 ? resolution : (scale == BandScale::bark ? 24 : 40));
+            const double low = toScale(scale, binWidth);
+            const double high = toScale(scale, nyquist);
+            for (int b = 0; b < numRequested; ++b)
+                centres.push_back(fromScale(scale, low + (high - low) * b / (numRequested - 1)));
+        }
+
+        // centres in bins, at least one bin apart
+        centreBins.clear();
+        for (auto centre : centres) {
+            const double position = jlimit(0.0, (double)(numBins - 1), centre / binWidth);
+            if (centreBins.empty() || position >= centreBins.back() + 1.0)
+                centreBins.push_back(position);
+        }
+        if (centreBins.size() < 2)
+            centreBins = { 0.0, (double)(numBins - 1) };
+
+        numBands = (int)centreBins.size();
+
+        lowerBand.allocate((size_t)numBins, false);
+        upperWeight.allocate((size_t)numBins, false);
+
+        int band = 0;
+        for (int k = 0; k < numBins; ++k) {
+            while (band < numBands - 2 && k >= centreBins[(size_t)band + 1])
+                ++band;
+
+            const double position = (k - centreBins[(size_t)band]) / (centreBins[(size_t)band + 1] - centreBins[(size_t)band]);
+            lowerBand[k] = band;
+            upperWeight[k] = (float)jlimit(0.0, 1.0, position);
+        }
+    }
+
+    int getNumBands() const noexcept { return numBands; }
+    int getNumBins() const noexcept { return numBins; }
+
+    /** Weighted sums of the bin values of every band */
+    void sumBins(const float* binValues, float* bandValues) const noexcept
+    {
+        FloatVectorOperations::clear(bandValues, numBands);
+
+        for (int k = 0; k < numBins; ++k) {
+            const float upper = upperWeight[k] * binValues[k];
+            bandValues[lowerBand[k]] += binValues[k] - upper;
+            bandValues[lowerBand[k] + 1] += upper;
+        }
+    }
+
+    /** Interpolates the band values for every bin */
+    void spreadBands(const float* bandValues, float* binValues) const noexcept
+    {
+        for (int k = 0; k < numBins; ++k) {
+            const float lower = bandValues[lowerBand[k]];
+            binValues[k] = lower + upperWeight[k] * (bandValues[lowerBand[k] + 1] - lower);
+        }
+    }
+
+private:
+    static double toScale(const BandScale scale, const double frequency)
+    {
+        if (scale == BandScale::bark)
+            return 26.81 * frequency / (1960.0 + frequency) - 0.53;
+
+        return 21.4 * std::log10(1.0 + 0.00437 * frequency);
+    }
+
+    static double fromScale(const BandScale scale, const double value)
+    {
+        if (scale == BandScale::bark)
+            return 1960.0 * (value + 0.53) / (26.28 - value);
+
+        return (std::pow(10.0, value / 21.4) - 1.0) / 0.00437;
+    }
+
+    int numBins = 0;
+    int numBands = 0;
+    std::vector<double> centreBins;
+    HeapBlock<int> lowerBand;
+    HeapBlock<float> upperWeight;
+
+    JUCE_DECLARE_NON_COPYABLE(BandGrouping)
+};
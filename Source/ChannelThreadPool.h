@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    ChannelThreadPool.h
+    Created: 16 Oct 2026 11:05:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WorkerWakeup.h"
+
+using namespace juce;
+
+/**
+ Fixed pool of worker threads that spreads the channels of one frame over all cores and joins
+ before returning. The calling (audio) thread takes part in the work, so a pool of N threads
+ starts N - 1 workers. All threads are started in start(), run() neither allocates nor locks: the workers
+ sleep on a WorkerWakeup between runs. They run at real-time priority, unless the pool is started with
+ Priority::normal for offline work, where they shouldn't compete with the audio threads of the system.
+
+ Every thread owns a contiguous range of the tasks and takes them from the front. A thread that
+ runs out of work steals from the ranges of the others, so a channel that happens to be slow
+ doesn't leave the remaining threads idle.
+ */
+class ChannelThreadPool {
+public:
+    enum class Priority {
+        realtime,
+        normal
+    };
+
+    ChannelThreadPool() { }
+
+    ~ChannelThreadPool()
+    {
+        stop();
+    }
+
+    /** Starts numThreads - 1 workers, don't call this from the audio thread. */
+    void start(const int numThreads, const Priority priority = Priority::realtime)
+    {
+        stop();
+
+        numParticipants = jmax(1, numThreads);
+        ranges.reset(new TaskRange[(size_t)numParticipants]);
+
+        for (int i = 1; i < numParticipants; ++i) {
+            workers.push_back(std::make_unique<Worker>(*this, i));
+
+            if (priority == Priority::realtime)
+                startRealtimeWorker(*workers.back());
+            else
+                workers.back()->startThread();
+        }
+    }
+
+    void stop()
+    {
+        for (auto& worker : workers)
+            worker->wakeup.stopWorker(*worker);
+
+        workers.clear();
+        numParticipants = 1;
+    }
+
+    /** The number of threads taking part in run(), including the calling one */
+    int getNumThreads() const noexcept { return numParticipants; }
+
+    /** Calls job(taskIndex) for every taskIndex in [0, numTasks) on all threads and returns when all are done.
+        Tasks must be independent of each other. */
+    template <typename Job>
+    void run(const int numTasks, Job& job)
+    {
+        jobContext = &job;
+        jobInvoker = [](void* context, const int taskIndex) { (*static_cast<Job*>(context))(taskIndex); };
+
+        for (int i = 0; i < numParticipants; ++i) {
+            ranges[i].next.store(numTasks * i / numParticipants, std::memory_order_relaxed);
+            ranges[i].end = numTasks * (i + 1) / numParticipants;
+        }
+
+        numRemaining.store(numTasks);
+        runIsOpen.store(true);
+
+        for (auto& worker : workers)
+            worker->wakeup.signal();
+
+        work(0);
+
+        while (numRemaining.load() > 0)
+            Thread::yield();
+
+        // make sure no worker is still looking at this run before the next one overwrites the ranges
+        runIsOpen.store(false);
+        while (numActive.load() > 0)
+            Thread::yield();
+    }
+
+private:
+    struct alignas(64) TaskRange {
+        std::atomic<int> next { 0 };
+        int end = 0;
+    };
+
+    class Worker : public Thread {
+    public:
+        Worker(ChannelThreadPool& pool, const int index)
+            : Thread("ChannelThreadPool worker")
+            , owner(pool)
+            , participantIndex(index)
+        {
+        }
+
+        void run() override
+        {
+            while (wakeup.waitForSignal(*this)) {
+                owner.numActive.fetch_add(1);
+                if (owner.runIsOpen.load())
+                    owner.work(participantIndex);
+                owner.numActive.fetch_sub(1);
+            }
+        }
+
+        WorkerWakeup wakeup;
+
+    private:
+        ChannelThreadPool& owner;
+        const int participantIndex;
+    };
+
+    /** Works through the own range first, then steals from the others until nothing is left */
+    void work(const int participantIndex)
+    {
+        for (int offset = 0; offset < numParticipants; ++offset) {
+            auto& range = ranges[(participantIndex + offset) % numParticipants];
+
+            for (int task = range.next.fetch_add(1); task < range.end; task = range.next.fetch_add(1)) {
+                jobInvoker(jobContext, task);
+                numRemaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    }
+
+    int numParticipants = 1;
+    std::unique_ptr<TaskRange[]> ranges { new TaskRange[1] };
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    void* jobContext = nullptr;
+    void (*jobInvoker)(void*, int) = nullptr;
+
+    std::atomic<int> numRemaining { 0 };
+    std::atomic<int> numActive { 0 };
+    std::atomic<bool> runIsOpen { false };
+
+    JUCE_DECLARE_NON_COPYABLE(ChannelThreadPool)
+};
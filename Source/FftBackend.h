@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    FftBackend.h
+    Created: 17 Oct 2026 9:02:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SimdRealFft.h"
+
+using namespace juce;
+
+/**
+ Default FFT backend of all processors, can be set as a preprocessor definition of the project:
+ 0 = automatic (benchmark on the first construction of each size), 1 = juce::dsp::FFT, 2 = bundled SIMD FFT
+ */
+#ifndef OVERLAP_ADD_FFT_BACKEND
+ #define OVERLAP_ADD_FFT_BACKEND 0
+#endif
+
+enum class FftBackendType {
+    /** measures all engines for the given size once and keeps the fastest one for all instances of that size */
+    automatic = 0,
+    /** juce::dsp::FFT, i.e. whatever engine JUCE was built with (fallback, FFTW, IPP, vDSP) */
+    juce = 1,
+    /** the bundled SimdRealFft */
+    simd = 2
+};
+
+/** Interface of the engines behind FftBackend; the data layout is the one of juce::dsp::FFT */
+template <typename FloatType>
+class FftEngine {
+public:
+    virtual ~FftEngine() { }
+
+    virtual void performRealOnlyForwardTransform(FloatType* inputOutputData, bool onlyCalculateNonNegativeFrequencies) const noexcept = 0;
+    virtual void performRealOnlyInverseTransform(FloatType* inputOutputData) const noexcept = 0;
+};
+
+/** juce::dsp::FFT, single precision only */
+class JuceFftEngine : public FftEngine<float> {
+public:
+    explicit JuceFftEngine(const int order) : fft(order) { }
+
+    void performRealOnlyForwardTransform(float* d, bool onlyCalculateNonNegativeFrequencies) const noexcept override
+    {
+        fft.performRealOnlyForwardTransform(d, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransform(float* d) const noexcept override
+    {
+        fft.performRealOnlyInverseTransform(d);
+    }
+
+private:
+    dsp::FFT fft;
+};
+
+template <typename FloatType>
+class SimdFftEngine : public FftEngine<FloatType> {
+public:
+    explicit SimdFftEngine(const int order) : fft(order) { }
+
+    void performRealOnlyForwardTransform(FloatType* d, bool onlyCalculateNonNegativeFrequencies) const noexcept override
+    {
+        fft.performRealOnlyForwardTransform(d, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransform(FloatType* d) const noexcept override
+    {
+        fft.performRealOnlyInverseTransform(d);
+    }
+
+private:
+    SimdRealFft<FloatType> fft;
+};
+
+/**
+ The FFT the processors hand to their subclasses as `fft`. It has the same interface as
+ juce::dsp::FFT's real-only transforms (so processFrameInBuffer() code works unchanged),
+ but runs on the engine chosen at construction. As with juce::dsp::FFT, the buffers passed to
+ the transforms have to hold 2 * getSize() values. FloatType is float or double; as juce::dsp::FFT
+ only works in single precision, double transforms always run on the bundled SimdRealFft.
+ */
+template <typename FloatType>
+class FftBackend {
+public:
+    FftBackend(const int order, const FftBackendType type = (FftBackendType)OVERLAP_ADD_FFT_BACKEND)
+        : size(1 << order)
+        , backendType(resolveType(type, order))
+        , engine(createEngine(backendType, order))
+        , batchFft(order)
+    {
+    }
+
+    int getSize() const noexcept { return size; }
+
+    /** The engine in use, never FftBackendType::automatic */
+    FftBackendType getType() const noexcept { return backendType; }
+
+    void performRealOnlyForwardTransform(FloatType* inputOutputData, bool onlyCalculateNonNegativeFrequencies = false) const noexcept
+    {
+        engine->performRealOnlyForwardTransform(inputOutputData, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransform(FloatType* inputOutputData) const noexcept
+    {
+        engine->performRealOnlyInverseTransform(inputOutputData);
+    }
+
+    /** The number of channels the batch transforms work on at once */
+    static constexpr int batchSize = SimdRealFft<FloatType>::batchSize;
+
+    /**
+     Transforms batchSize channels at once on channel-interleaved, SIMD aligned data, see
+     SimdRealFft::performRealOnlyForwardTransformBatch(). This always runs on the bundled SIMD FFT,
+     as it is the only engine working on one channel per SIMD lane.
+     */
+    void performRealOnlyForwardTransformBatch(FloatType* interleavedData, bool onlyCalculateNonNegativeFrequencies = false) const noexcept
+    {
+        batchFft.performRealOnlyForwardTransformBatch(interleavedData, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransformBatch(FloatType* interleavedData) const noexcept
+    {
+        batchFft.performRealOnlyInverseTransformBatch(interleavedData);
+    }
+
+    /** juce::dsp::FFT only exists in single precision */
+    static constexpr bool hasJuceEngine = std::is_same<FloatType, float>::value;
+
+    static std::unique_ptr<FftEngine<FloatType>> createEngine(const FftBackendType type, const int order)
+    {
+        if (type == FftBackendType::juce)
+            return createJuceEngine(order, FloatType());
+
+        return std::make_unique<SimdFftEngine<FloatType>>(order);
+    }
+
+    /** Times a forward/inverse round trip of every engine and returns the fastest one.
+        Takes a few milliseconds for large sizes, so only call it during setup. */
+    static FftBackendType findFastest(const int order)
+    {
+        const int fftSize = 1 << order;
+        const int numRuns = jlimit(4, 64, (1 << 18) / fftSize);
+
+        std::vector<FloatType> data((size_t)(2 * fftSize));
+
+        FftBackendType fastest = FftBackendType::simd;
+        auto fastestTicks = std::numeric_limits<int64>::max();
+
+        for (auto type : { FftBackendType::juce, FftBackendType::simd }) {
+            if (type == FftBackendType::juce && ! hasJuceEngine)
+                continue;
+
+            auto candidate = createEngine(type, order);
+
+            // the minimum over the runs is the least disturbed by the rest of the system
+            auto bestTicks = std::numeric_limits<int64>::max();
+            for (int run = 0; run <= numRuns; ++run) {
+                for (int n = 0; n < fftSize; ++n)
+                    data[(size_t)n] = (FloatType)((n * 7919) % 1024) / (FloatType)512 - (FloatType)1;
+
+                const auto start = Time::getHighResolutionTicks();
+                candidate->performRealOnlyForwardTransform(data.data(), true);
+                candidate->performRealOnlyInverseTransform(data.data());
+                const auto ticks = Time::getHighResolutionTicks() - start;
+
+                // the first run only warms up the caches
+                if (run > 0)
+                    bestTicks = jmin(bestTicks, ticks);
+            }
+
+            if (bestTicks < fastestTicks) {
+                fastestTicks = bestTicks;
+                fastest = type;
+            }
+        }
+
+        return fastest;
+    }
+
+private:
+    static FftBackendType resolveType(const FftBackendType type, const int order)
+    {
+        // with a single engine there is nothing to choose
+        if (! hasJuceEngine)
+            return FftBackendType::simd;
+
+        if (type == FftBackendType::automatic)
+            return getFastest(order);
+
+        return type;
+    }
+
+    /** findFastest(), measured once per order and process, so all instances of a size run the same engine
+        and give the same output */
+    static FftBackendType getFastest(const int order)
+    {
+        static CriticalSection lock;
+        static FftBackendType fastestOfOrder[32] = {};
+
+        jassert(isPositiveAndBelow(order, 32));
+        const ScopedLock sl(lock);
+
+        if (fastestOfOrder[order] == FftBackendType::automatic)
+            fastestOfOrder[order] = findFastest(order);
+
+        return fastestOfOrder[order];
+    }
+
+    static std::unique_ptr<FftEngine<float>> createJuceEngine(const int order, float) { return std::make_unique<JuceFftEngine>(order); }
+    static std::unique_ptr<FftEngine<double>> createJuceEngine(const int, double) { return nullptr; }
+
+    const int size;
+    const FftBackendType backendType;
+    std::unique_ptr<FftEngine<FloatType>> engine;
+    SimdRealFft<FloatType> batchFft;
+
+    JUCE_DECLARE_NON_COPYABLE(FftBackend)
+};
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    FftWindow.h
+    Created: 16 Oct 2026 9:48:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AlignedArray.h"
+
+using namespace juce;
+
+enum class FftWindowType {
+    hann,
+    hamming,
+    blackmanHarris,
+    sqrtHann,
+    kaiser
+};
+
+/**
+ Analysis and synthesis window tables for weighted overlap-add.
+ Both tables are periodic (so they tile exactly at power-of-two hops) and 64 byte aligned.
+ The synthesis table has the overlap-add normalization for the chosen hop baked in: for every
+ position within a hop, the sum of analysis * synthesis over all overlapping frames is one, so
+ an unmodified frame reconstructs the input exactly and no output scaling is needed.
+ FloatType is the type of the frames the tables are applied to, float or double.
+ */
+template <typename FloatType>
+class FftWindow {
+public:
+    FftWindow() { }
+
+    /** Fills both tables, don't call this from the audio thread.
+     @param kaiserBeta shape parameter, only used for FftWindowType::kaiser
+     */
+    void create(const FftWindowType type, const int fftSize, const int hopSize, const float kaiserBeta = 8.0f)
+    {
+        jassert(fftSize % hopSize == 0);
+
+        // one extra sample so a symmetric table of fftSize + 1 can be cut down to a periodic one
+        analysis.allocate(fftSize + 1, false);
+        synthesis.allocate(fftSize, false);
+
+        fillPeriodic(analysis.get(), fftSize, type, kaiserBeta);
+        FloatVectorOperations::copy(synthesis.get(), analysis.get(), fftSize);
+
+        normaliseSynthesis(fftSize, hopSize);
+    }
+
+    /**
+     Fills both tables with an asymmetric low-latency pair, don't call this from the audio thread.
+     The analysis window still spans the whole frame for the frequency resolution, but the synthesis window only
+     covers its last subFrameSize samples, with the product of both a Hann window of that length. So only the end of
+     every frame reaches the output and the delay through the processor drops from fftSize to subFrameSize.
+     @param subFrameSize length of the synthesis window, from 2 * hopSize to fftSize
+     */
+    void createLowLatency(const int fftSize, const int hopSize, const int subFrameSize)
+    {
+        jassert(fftSize % hopSize == 0 && subFrameSize >= 2 * hopSize && subFrameSize <= fftSize);
+
+        analysis.allocate(fftSize + 1, false);
+        synthesis.allocate(fftSize, false);
+
+        const int half = subFrameSize / 2;
+        const int riseLength = fftSize - half;
+        const int synthesisStart = fftSize - subFrameSize;
+
+        for (int n = 0; n < fftSize; ++n) {
+            // the rising half of a sqrt Hann over the frame, then the falling half of one over the sub-frame
+            const double analysisGain = n < riseLength ? std::sin(0.5 * MathConstants<double>::pi * n / riseLength)
+                                                       : std::cos(0.5 * MathConstants<double>::pi * (n - riseLength) / half);
+            const double product = n < synthesisStart ? 0.0 : std::pow(std::sin(MathConstants<double>::pi * (n - synthesisStart) / subFrameSize), 2.0);
+
+            analysis[n] = (FloatType)analysisGain;
+            synthesis[n] = analysisGain > 0.0 ? (FloatType)(product / analysisGain) : FloatType();
+        }
+
+        normaliseSynthesis(fftSize, hopSize);
+    }
+
+    /**
+     Fills both tables for overlap-save fast convolution, don't call this from the audio thread.
+     The analysis window is rectangular and the synthesis window keeps only the last hop of every frame,
+     which is the part of the circular convolution with an impulse response of hopSize samples that is free
+     of wrap-around.
+     */
+    void createOverlapSave(const int fftSize, const int hopSize)
+    {
+        analysis.allocate(fftSize + 1, false);
+        synthesis.allocate(fftSize, false);
+
+        FloatVectorOperations::fill(analysis.get(), (FloatType)1, fftSize + 1);
+        FloatVectorOperations::clear(synthesis.get(), fftSize - hopSize);
+        FloatVectorOperations::fill(synthesis.get() + fftSize - hopSize, (FloatType)1, hopSize);
+    }
+
+    const FloatType* getAnalysisWindow() const noexcept { return analysis.get(); }
+    const FloatType* getSynthesisWindow() const noexcept { return synthesis.get(); }
+
+    /** frame[i] = samples[i] * analysis[offset + i] for i < num, converting the samples to FloatType if they are of another type */
+    template <typename SampleType>
+    void applyAnalysis(FloatType* frame, const SampleType* samples, const int offset, const int num) const noexcept
+    {
+        multiply(frame, samples, analysis.get() + offset, num);
+    }
+
+    /** output[i] += frame[i] * synthesis[offset + i] for i < num, accumulated in the type of the output */
+    template <typename SampleType>
+    void addSynthesised(SampleType* output, const FloatType* frame, const int offset, const int num) const noexcept
+    {
+        addWithMultiply(output, frame, synthesis.get() + offset, num);
+    }
+
+private:
+    // the vector operations where all types match, a converting loop otherwise
+    static void multiply(FloatType* dest, const FloatType* samples, const FloatType* table, const int num) noexcept
+    {
+        FloatVectorOperations::multiply(dest, samples, table, num);
+    }
+
+    template <typename SampleType>
+    static void multiply(FloatType* dest, const SampleType* samples, const FloatType* table, const int num) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+            dest[i] = (FloatType)samples[i] * table[i];
+    }
+
+    static void addWithMultiply(FloatType* dest, const FloatType* frame, const FloatType* table, const int num) noexcept
+    {
+        FloatVectorOperations::addWithMultiply(dest, frame, table, num);
+    }
+
+    template <typename SampleType>
+    static void addWithMultiply(SampleType* dest, const FloatType* frame, const FloatType* table, const int num) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+            dest[i] += (SampleType)(frame[i] * table[i]);
+    }
+
+    static void fillPeriodic(FloatType* table, const int fftSize, const FftWindowType type, const float kaiserBeta)
+    {
+        using Window = dsp::WindowingFunction<FloatType>;
+        using Method = typename Window::WindowingMethod;
+
+        const auto size = (size_t)fftSize + 1;
+
+        switch (type) {
+        case FftWindowType::hann:
+            Window::fillWindowingTables(table, size, Method::hann, false);
+            break;
+        case FftWindowType::hamming:
+            Window::fillWindowingTables(table, size, Method::hamming, false);
+            break;
+        case FftWindowType::blackmanHarris:
+            Window::fillWindowingTables(table, size, Method::blackmanHarris, false);
+            break;
+        case FftWindowType::sqrtHann:
+            Window::fillWindowingTables(table, size, Method::hann, false);
+            for (int n = 0; n < fftSize; ++n)
+                table[n] = std::sqrt(table[n]);
+            break;
+        case FftWindowType::kaiser:
+            Window::fillWindowingTables(table, size, Method::kaiser, false, (FloatType)kaiserBeta);
+            break;
+        }
+    }
+
+    void normaliseSynthesis(const int fftSize, const int hopSize)
+    {
+        for (int n = 0; n < hopSize; ++n) {
+            FloatType overlapGain = 0;
+            for (int k = n; k < fftSize; k += hopSize)
+                overlapGain += analysis[k] * synthesis[k];
+
+            // a window that is zero at every frame position of a sample can't reconstruct it
+            jassert(overlapGain > 0);
+
+            for (int k = n; k < fftSize; k += hopSize)
+                synthesis[k] /= overlapGain;
+        }
+    }
+
+    AlignedArray<FloatType> analysis;
+    AlignedArray<FloatType> synthesis;
+
+    JUCE_DECLARE_NON_COPYABLE(FftWindow)
+};
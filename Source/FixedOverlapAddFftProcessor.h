@@ -0,0 +1,294 @@
+/*
+  ==============================================================================
+
+    FixedOverlapAddFftProcessor.h
+    Created: 19 Oct 2026 10:14:00am
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FftWindow.h"
+#include "FftBackend.h"
+
+using namespace juce;
+
+/**
+ The overlap-add pipeline of OverlapAddFftProcessor for a configuration known at compile time:
+ fftSize = 2^FftOrder, hopSize = fftSize / 2^HopDivider and up to MaxNumChannels channels.
+
+ All storage (input ring, output accumulator, frames and window tables) lives inline in std::arrays, so
+ prepare() never allocates, and the ring masks and frame lengths are constants. The loops that window the
+ frames and overlap-add them therefore run over a fixed number of samples the compiler can unroll and
+ vectorize, without the runtime size checks of the generic loops. The object is a few fftSize long per
+ channel, so create it on the heap for large orders.
+
+ It covers the common case only: frames are processed on the audio thread, one channel after the other, with
+ processFrameInBuffer() or processChannelFrame() working on `fftInOutBuffer[ch]` in place. Use
+ OverlapAddFftProcessor for configurations that change at runtime, or for the scheduling, layout and
+ spectrum options.
+
+ As in OverlapAddFftProcessorBase, the frame callbacks are resolved statically: Derived implements them (CRTP)
+ and has to declare them public or befriend this class. FixedOverlapAddFftProcessor is Derived for processors
+ that override them as virtual functions instead.
+ @code
+ class MyProcessor final : public FixedOverlapAddFftProcessorBase<MyProcessor, 10, 3>
+ {
+     friend FixedOverlapAddFftProcessorBase<MyProcessor, 10, 3>;
+
+     void processChannelFrame(const int ch)
+     {
+         fft.performRealOnlyForwardTransform(fftInOutBuffer[ch].data(), true);
+         // ...
+         fft.performRealOnlyInverseTransform(fftInOutBuffer[ch].data());
+     }
+ };
+ */
+template <typename Derived, int FftOrder, int HopDivider, int MaxNumChannels = 2, typename Sample = float>
+class FixedOverlapAddFftProcessorBase {
+public:
+    using SampleType = Sample;
+
+    static constexpr int fftSize = 1 << FftOrder;
+    static constexpr int hopSize = fftSize >> HopDivider;
+    static constexpr int maxNumChannels = MaxNumChannels;
+
+    static_assert(HopDivider > 0, "the frames have to overlap by at least 50%");
+    static_assert(HopDivider <= FftOrder, "the hop can't be shorter than one sample");
+    static_assert(MaxNumChannels > 0, "at least one channel is needed");
+
+    /**
+     @param windowType the window used for analysis and synthesis
+     @param fftBackendType the FFT engine behind `fft`, by default the one set with OVERLAP_ADD_FFT_BACKEND
+     */
+    FixedOverlapAddFftProcessorBase(const FftWindowType windowType = FftWindowType::hann,
+                                    const FftBackendType fftBackendType = (FftBackendType)OVERLAP_ADD_FFT_BACKEND)
+        : fft(FftOrder, fftBackendType)
+    {
+        setWindowType(windowType);
+        reset();
+    }
+
+    /** Changes the analysis and synthesis window, don't call this from the audio thread.
+     @param kaiserBeta shape parameter, only used for FftWindowType::kaiser
+     */
+    void setWindowType(const FftWindowType windowType, const float kaiserBeta = 8.0f)
+    {
+        FftWindow<SampleType> window;
+        window.create(windowType, fftSize, hopSize, kaiserBeta);
+        std::copy(window.getAnalysisWindow(), window.getAnalysisWindow() + fftSize, analysisWindow.begin());
+        std::copy(window.getSynthesisWindow(), window.getSynthesisWindow() + fftSize, synthesisWindow.begin());
+    }
+
+    /** Returns the delay in samples between input and output */
+    int getLatencySamples() const { return latencySamples; }
+
+    /** Returns how long the output can go on after the input has stopped */
+    int getTailLengthSamples() const { return latencySamples + fftSize; }
+
+    /** Doesn't allocate, the channel counts only have to fit MaxNumChannels */
+    void prepare(const double newSampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        jassert(numInputChannels <= MaxNumChannels && numOutputChannels <= MaxNumChannels);
+        ignoreUnused(maximumBlockSize);
+
+        sampleRate = newSampleRate;
+        numInpChannel = jmin(numInputChannels, MaxNumChannels);
+        numOutChannel = jmin(numOutputChannels, MaxNumChannels);
+        reset();
+    }
+
+    /** Clears all buffered audio and restarts the timeline, can be called from the audio thread */
+    void reset()
+    {
+        for (auto& channel : inputRing)
+            channel.fill(SampleType());
+        for (auto& channel : outputRing)
+            channel.fill(SampleType());
+
+        inputWritePosition = 0;
+        outputReadPosition = 0;
+        outputWritePosition = latencySamples + hopSize;
+        hopCounter = 0;
+    }
+
+    void process(const dsp::ProcessContextReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::ProcessContextNonReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
+    {
+        const auto inputBlockLength = (int)inputBlock.getNumSamples();
+        const auto numChIn = jmin(static_cast<int>(inputBlock.getNumChannels()), numInpChannel);
+        const auto numChOut = jmin(static_cast<int>(outputBlock.getNumChannels()), numOutChannel);
+
+        // runs end at the end of the block or at the next hop, as in OverlapAddFftProcessor
+        int i = 0;
+        while (i < inputBlockLength) {
+            const int numSamples = jmin(inputBlockLength - i, hopSize - hopCounter);
+
+            // the input is stored before the output is read, as both may share memory (replacing context)
+            for (int ch = 0; ch < numChIn; ++ch)
+                writeInput(ch, inputBlock.getChannelPointer((size_t)ch) + i, numSamples);
+            inputWritePosition = (inputWritePosition + numSamples) & inputMask;
+
+            for (int ch = 0; ch < numChOut; ++ch)
+                readOutput(ch, outputBlock.getChannelPointer((size_t)ch) + i, numSamples);
+            outputReadPosition = (outputReadPosition + numSamples) & outputMask;
+
+            hopCounter += numSamples;
+            if (hopCounter == hopSize) {
+                hopCounter = 0;
+                processHop(numChIn, numChOut);
+            }
+
+            i += numSamples;
+        }
+
+        for (int ch = numChOut; ch < (int)outputBlock.getNumChannels(); ++ch)
+            FloatVectorOperations::clear(outputBlock.getChannelPointer((size_t)ch), inputBlockLength);
+    }
+
+protected:
+    // ====== the hooks of Derived. These are the defaults, a Derived member of the same name replaces them
+
+    /**
+     Gets called with the windowed frames of all channels in `fftInOutBuffer`, still in time domain.
+     By default, calls processChannelFrame() for every channel.
+     @param numChannels the number of channels of `fftInOutBuffer` you should use
+     */
+    void processFrameInBuffer(const int numChannels)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            derived().processChannelFrame(ch);
+    }
+
+    /** Same as processFrameInBuffer(), but for a single channel of `fftInOutBuffer` */
+    void processChannelFrame(const int ch) { }
+
+    FftBackend<SampleType> fft;
+    double sampleRate = 44100.0;
+
+    /** One frame per channel, with room for the 2 * fftSize values of the real-only transforms */
+    alignas(64) std::array<std::array<SampleType, 2 * fftSize>, MaxNumChannels> fftInOutBuffer;
+
+private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+
+    // the input ring holds exactly one frame, so the latest frame always starts at the write position of its
+    // mirrored layout. The output has to reach from the read position up to the end of the latest frame
+    static constexpr int latencySamples = fftSize;
+    static constexpr int inputCapacity = fftSize;
+    static constexpr int inputMask = inputCapacity - 1;
+    static constexpr int outputCapacity = 2 * fftSize;
+    static constexpr int outputMask = outputCapacity - 1;
+
+    static_assert(latencySamples + hopSize <= outputCapacity, "the output ring has to hold the latest frame");
+
+    /** Stores a run of input samples at the write position and in its mirror */
+    void writeInput(const int ch, const SampleType* source, const int numSamples) noexcept
+    {
+        SampleType* data = inputRing[(size_t)ch].data();
+        const int firstRun = jmin(numSamples, inputCapacity - inputWritePosition);
+
+        FloatVectorOperations::copy(data + inputWritePosition, source, firstRun);
+        FloatVectorOperations::copy(data + inputWritePosition + inputCapacity, source, firstRun);
+        FloatVectorOperations::copy(data, source + firstRun, numSamples - firstRun);
+        FloatVectorOperations::copy(data + inputCapacity, source + firstRun, numSamples - firstRun);
+    }
+
+    /** Folds a run of output samples from both halves of the accumulator and clears them for the next overlap-add */
+    void readOutput(const int ch, SampleType* destination, const int numSamples) noexcept
+    {
+        SampleType* data = outputRing[(size_t)ch].data();
+        const int firstRun = jmin(numSamples, outputCapacity - outputReadPosition);
+
+        readRun(destination, data + outputReadPosition, firstRun);
+        readRun(destination + firstRun, data, numSamples - firstRun);
+    }
+
+    static void readRun(SampleType* destination, SampleType* primary, const int numSamples) noexcept
+    {
+        FloatVectorOperations::add(destination, primary, primary + outputCapacity, numSamples);
+        FloatVectorOperations::clear(primary, numSamples);
+        FloatVectorOperations::clear(primary + outputCapacity, numSamples);
+    }
+
+    /** Windows the latest frame of every channel, runs the frame callback and overlap-adds the result */
+    void processHop(const int numChIn, const int numChOut)
+    {
+        for (int ch = 0; ch < numChIn; ++ch) {
+            const SampleType* latest = inputRing[(size_t)ch].data() + inputWritePosition;
+            SampleType* frame = fftInOutBuffer[(size_t)ch].data();
+
+            for (int n = 0; n < fftSize; ++n)
+                frame[n] = latest[n] * analysisWindow[(size_t)n];
+        }
+
+        // output channels without an input get a silent frame
+        for (int ch = numChIn; ch < numChOut; ++ch)
+            std::fill(fftInOutBuffer[(size_t)ch].begin(), fftInOutBuffer[(size_t)ch].begin() + fftSize, SampleType());
+
+        derived().processFrameInBuffer(jmax(numChIn, numChOut));
+
+        // the part of a frame running past the first half of the accumulator lands in its mirror
+        const int frameStart = (outputWritePosition - fftSize) & outputMask;
+        for (int ch = 0; ch < numChOut; ++ch) {
+            SampleType* output = outputRing[(size_t)ch].data() + frameStart;
+            const SampleType* frame = fftInOutBuffer[(size_t)ch].data();
+
+            for (int n = 0; n < fftSize; ++n)
+                output[n] += frame[n] * synthesisWindow[(size_t)n];
+        }
+
+        outputWritePosition = (outputWritePosition + hopSize) & outputMask;
+    }
+
+    alignas(64) std::array<SampleType, fftSize> analysisWindow;
+    alignas(64) std::array<SampleType, fftSize> synthesisWindow;
+    alignas(64) std::array<std::array<SampleType, 2 * inputCapacity>, MaxNumChannels> inputRing;
+    alignas(64) std::array<std::array<SampleType, 2 * outputCapacity>, MaxNumChannels> outputRing;
+
+    int numInpChannel = 0;
+    int numOutChannel = 0;
+    int inputWritePosition = 0;
+    int outputReadPosition = 0;
+    int outputWritePosition = 0;
+    int hopCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(FixedOverlapAddFftProcessorBase)
+};
+
+/**
+ FixedOverlapAddFftProcessorBase with virtual frame callbacks, for processors that override them in a subclass.
+ Costs one virtual call per frame (or per channel of a frame).
+ */
+template <int FftOrder, int HopDivider, int MaxNumChannels = 2, typename Sample = float>
+class FixedOverlapAddFftProcessor
+    : public FixedOverlapAddFftProcessorBase<FixedOverlapAddFftProcessor<FftOrder, HopDivider, MaxNumChannels, Sample>, FftOrder, HopDivider, MaxNumChannels, Sample> {
+    using Base = FixedOverlapAddFftProcessorBase<FixedOverlapAddFftProcessor<FftOrder, HopDivider, MaxNumChannels, Sample>, FftOrder, HopDivider, MaxNumChannels, Sample>;
+    friend Base;
+
+public:
+    FixedOverlapAddFftProcessor(const FftWindowType windowType = FftWindowType::hann,
+                                const FftBackendType fftBackendType = (FftBackendType)OVERLAP_ADD_FFT_BACKEND)
+        : Base(windowType, fftBackendType)
+    {
+    }
+
+    virtual ~FixedOverlapAddFftProcessor() { }
+
+protected:
+    // see FixedOverlapAddFftProcessorBase for what they do by default
+    virtual void processFrameInBuffer(const int numChannels) { Base::processFrameInBuffer(numChannels); }
+    virtual void processChannelFrame(const int ch) { Base::processChannelFrame(ch); }
+};
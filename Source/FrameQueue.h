@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    FrameQueue.h
+    Created: 16 Oct 2026 10:31:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ Wait-free single-producer/single-consumer queue of preallocated multichannel frames.
+ The audio thread submits windowed frames, a worker thread processes them in place in submission
+ order, and the audio thread collects them again once they are completed. Slots circulate through
+ the three stages by means of three counters, each one written by a single thread only, so no
+ stage ever blocks or allocates. The counters are unsigned and only ever compared by difference,
+ so they may wrap around.
+ */
+template <typename FloatType>
+class FrameQueue {
+public:
+    struct Frame {
+        AudioBuffer<FloatType> buffer;
+        int frameStart = 0;
+        int numChIn = 0;
+        int numChOut = 0;
+    };
+
+    FrameQueue() { }
+
+    /** Allocates all slots, don't call this from the audio thread.
+     @param numSlots maximum number of frames in flight, has to be a power of two
+     */
+    void setSize(const int numSlots, const int numChannels, const int frameLength)
+    {
+        jassert(isPowerOfTwo(numSlots));
+
+        frames.resize((size_t)numSlots);
+        for (auto& frame : frames)
+            frame.buffer.setSize(numChannels, frameLength);
+
+        reset();
+    }
+
+    /** Forgets all frames, only call this while no worker is running. */
+    void reset()
+    {
+        numSubmitted.store(0);
+        numCompleted.store(0);
+        numCollected.store(0);
+    }
+
+    int getNumInFlight() const noexcept { return (int)(numSubmitted.load(std::memory_order_relaxed) - numCollected.load(std::memory_order_relaxed)); }
+
+    // ====== producer (audio thread)
+    bool canSubmit() const noexcept { return getNumInFlight() < (int)frames.size(); }
+
+    /** The slot to fill before calling submit(), only valid if canSubmit() */
+    Frame& getSubmitSlot() noexcept { return slot(numSubmitted.load(std::memory_order_relaxed)); }
+
+    void submit() noexcept { numSubmitted.fetch_add(1, std::memory_order_release); }
+
+    // ====== consumer (worker thread)
+    /** Returns the oldest frame waiting for processing, or nullptr if there is none */
+    Frame* getNextPending() noexcept
+    {
+        const auto index = numCompleted.load(std::memory_order_relaxed);
+        return index != numSubmitted.load(std::memory_order_acquire) ? &slot(index) : nullptr;
+    }
+
+    void markCompleted() noexcept { numCompleted.fetch_add(1, std::memory_order_release); }
+
+    // ====== collector (audio thread)
+    bool isOldestCompleted() const noexcept { return numCollected.load(std::memory_order_relaxed) != numCompleted.load(std::memory_order_acquire); }
+
+    /** The oldest frame still in flight, only valid if isOldestCompleted() */
+    Frame& getOldest() noexcept { return slot(numCollected.load(std::memory_order_relaxed)); }
+
+    void release() noexcept { numCollected.fetch_add(1, std::memory_order_release); }
+
+private:
+    Frame& slot(const uint32_t index) noexcept { return frames[index & (uint32_t)(frames.size() - 1)]; }
+
+    std::vector<Frame> frames;
+    std::atomic<uint32_t> numSubmitted { 0 };
+    std::atomic<uint32_t> numCompleted { 0 };
+    std::atomic<uint32_t> numCollected { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(FrameQueue)
+};
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    MirroredRingBuffer.h
+    Created: 16 Oct 2026 9:12:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ Multichannel circular buffer that stores every sample twice, at its position and one capacity
+ further. Any run of up to `capacity` samples that ends at the write position is therefore
+ available as a single contiguous pointer, so frames can be read without wrapping or modulo
+ arithmetic. The capacity is rounded up to a power of two; all channels share one write position.
+ */
+template <typename SampleType>
+class MirroredRingBuffer {
+public:
+    MirroredRingBuffer() { }
+
+    /** Allocates the buffer, don't call this from the audio thread. */
+    void setSize(const int numChannels, const int minimumCapacity)
+    {
+        capacity = nextPowerOfTwo(minimumCapacity);
+        mask = capacity - 1;
+        buffer.setSize(numChannels, 2 * capacity);
+        clear();
+    }
+
+    void clear()
+    {
+        buffer.clear();
+        writePosition = 0;
+    }
+
+    int getCapacity() const { return capacity; }
+
+    /** Writes numSamples (at most the capacity) at the write position without moving it.
+        Call advance() once all channels have been written. */
+    void write(const int ch, const SampleType* source, const int numSamples)
+    {
+        jassert(numSamples <= capacity);
+
+        const int firstRun = jmin(numSamples, capacity - writePosition);
+        const int secondRun = numSamples - firstRun;
+        SampleType* data = buffer.getWritePointer(ch);
+
+        FloatVectorOperations::copy(data + writePosition, source, firstRun);
+        FloatVectorOperations::copy(data + writePosition + capacity, source, firstRun);
+        FloatVectorOperations::copy(data, source + firstRun, secondRun);
+        FloatVectorOperations::copy(data + capacity, source + firstRun, secondRun);
+    }
+
+    void advance(const int numSamples) { writePosition = (writePosition + numSamples) & mask; }
+
+    /** Returns a contiguous pointer to the most recent numSamples (at most the capacity) of a channel */
+    const SampleType* getLatestSamples(const int ch, const int numSamples) const
+    {
+        jassert(numSamples <= capacity);
+
+        int start = writePosition - numSamples;
+        if (start < 0)
+            start += capacity;
+
+        return buffer.getReadPointer(ch, start);
+    }
+
+private:
+    AudioBuffer<SampleType> buffer;
+    int capacity = 0;
+    int mask = 0;
+    int writePosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(MirroredRingBuffer)
+};
+
+/**
+ Multichannel overlap-add accumulator with the same 2x layout as MirroredRingBuffer, used the
+ other way around: a frame of up to `capacity` samples is added contiguously starting at any
+ position, and the part running past the first half simply lands in the mirror. Reading a position
+ folds both halves together and clears them, so neither adding nor reading needs modulo arithmetic.
+ */
+template <typename SampleType>
+class MirroredOverlapAddBuffer {
+public:
+    MirroredOverlapAddBuffer() { }
+
+    /** Allocates the buffer, don't call this from the audio thread. */
+    void setSize(const int numChannels, const int minimumCapacity)
+    {
+        capacity = nextPowerOfTwo(minimumCapacity);
+        mask = capacity - 1;
+        buffer.setSize(numChannels, 2 * capacity);
+        clear();
+    }
+
+    void clear()
+    {
+        buffer.clear();
+        readPosition = 0;
+    }
+
+    int getCapacity() const { return capacity; }
+
+    /** Wraps any (possibly negative) position into the buffer */
+    int wrap(const int position) const { return position & mask; }
+
+    /** Returns a pointer to add a frame of up to `capacity` samples to, starting at the given position */
+    SampleType* getFrameWritePointer(const int ch, const int position) { return buffer.getWritePointer(ch, wrap(position)); }
+
+    /** Folds numSamples from the read position into destination and clears them so they are
+        ready for the next overlap-add. Call advance() once all channels have been read. */
+    void read(const int ch, SampleType* destination, const int numSamples)
+    {
+        jassert(numSamples <= capacity);
+
+        const int firstRun = jmin(numSamples, capacity - readPosition);
+        SampleType* data = buffer.getWritePointer(ch);
+
+        readRun(destination, data + readPosition, data + readPosition + capacity, firstRun);
+        readRun(destination + firstRun, data, data + capacity, numSamples - firstRun);
+    }
+
+    void advance(const int numSamples) { readPosition = (readPosition + numSamples) & mask; }
+
+    int getReadPosition() const { return readPosition; }
+
+private:
+    static void readRun(SampleType* destination, SampleType* primary, SampleType* mirror, const int numSamples)
+    {
+        FloatVectorOperations::add(destination, primary, mirror, numSamples);
+        FloatVectorOperations::clear(primary, numSamples);
+        FloatVectorOperations::clear(mirror, numSamples);
+    }
+
+    AudioBuffer<SampleType> buffer;
+    int capacity = 0;
+    int mask = 0;
+    int readPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(MirroredOverlapAddBuffer)
+};
@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    MultiResolutionFftProcessor.h
+    Created: 18 Oct 2026 5:02:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OverlapAddFftProcessor.h"
+
+using namespace juce;
+
+/**
+ Splits the signal into frequency bands and processes every band with its own FFT size at its own sample rate:
+ long frames with fine frequency resolution for the low band, short ones with fine time resolution for the high
+ bands. Each band is one ProcessorType instance.
+
+ The bands are split in the time domain before the FFTs, as a pyramid: a linear-phase lowpass at the crossover
+ decimates the input for the next lower band, and the higher band gets the input minus that lower band,
+ interpolated back up with the same lowpass. On the way back, the output of every lower band is interpolated
+ the same way and added to the higher one. The high band is the exact complement of the low band, so with
+ pass-through processors the output is the input, delayed, up to rounding. The filters only decide how
+ cleanly the bands are separated, which matters once the bands are processed differently.
+
+ A low band runs at a fraction of the sample rate, so its FFT only needs a fraction of the size for the same
+ frequency resolution: e.g. 128 samples at 48 kHz / 32 resolve as finely as 4096 at 48 kHz, for far less than
+ a 4096 point FFT on the full band costs.
+ @code
+ // 128 point frames at 1.5 kHz below 300 Hz, 256 at 12 kHz up to 3 kHz, 256 at 48 kHz above
+ MultiResolutionFftProcessor<SpectralDynamicProcessor> processor ({ { 7, 2, 5 }, { 8, 2, 2 }, { 8, 2, 0 } }, { 300.0f, 3000.0f });
+ @endcode
+
+ The bands are delayed to line up, so the latency of the whole processor is the one of the slowest band,
+ usually the lowest one, plus the delay of the crossover filters.
+
+ ProcessorType needs a (fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2) constructor and the interface of
+ OverlapAddFftProcessor, it is prepared with the sample rate of its band. The audio is ProcessorType::SampleType.
+ */
+template <typename ProcessorType>
+class MultiResolutionFftProcessor {
+public:
+    using SampleType = typename ProcessorType::SampleType;
+
+    struct Band {
+        /** the FFT size and hop at the sample rate of the band */
+        int fftSizeAsPowerOf2;
+        int hopSizeDividerAsPowerOf2;
+        /** the band runs at sampleRate / 2^decimationAsPowerOf2, 0 for the highest one. The Nyquist frequency
+            of a band has to lie above the crossover to the next higher band */
+        int decimationAsPowerOf2 = 0;
+    };
+
+    /**
+     @param bands the bands from the lowest to the highest frequencies, with non-increasing decimation
+     @param crossovers the frequencies in Hz between the bands, one less than there are bands, ascending
+     */
+    MultiResolutionFftProcessor(std::initializer_list<Band> bands, std::initializer_list<float> crossovers)
+    {
+        // the processing runs from the highest band down, so everything is stored in that order
+        for (auto band = std::rbegin(bands); band != std::rend(bands); ++band) {
+            processors.insert(processors.begin(), std::make_unique<ProcessorType>(band->fftSizeAsPowerOf2, band->hopSizeDividerAsPowerOf2));
+            levels.push_back(std::make_unique<Level>());
+            levels.back()->decimationAsPowerOf2 = band->decimationAsPowerOf2;
+            levels.back()->processor = processors.front().get();
+        }
+
+        auto crossover = std::rbegin(crossovers);
+        for (size_t level = 0; level + 1 < levels.size() && crossover != std::rend(crossovers); ++level, ++crossover)
+            levels[level]->crossoverFrequency = *crossover;
+
+        jassert(getNumBands() > 0 && (int)crossovers.size() == getNumBands() - 1);
+        jassert(levels.front()->decimationAsPowerOf2 == 0);
+    }
+
+    int getNumBands() const { return (int)processors.size(); }
+
+    /** The processor of a band, e.g. to set its parameters */
+    ProcessorType& getProcessor(const int band) { return *processors[(size_t)band]; }
+
+    /** Calls function(processor) for the processors of all bands */
+    template <typename Function>
+    void forEachProcessor(Function&& function)
+    {
+        for (auto& processor : processors)
+            function(*processor);
+    }
+
+    /** Returns the delay in samples between input and output, the same for all bands (valid after prepare()) */
+    int getLatencySamples() const { return latencySamples; }
+
+    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        numInpChannel = numInputChannels;
+        numOutChannel = numOutputChannels;
+        maxBlockSize = maximumBlockSize;
+
+        int levelBlockSize = maximumBlockSize;
+        for (size_t k = 0; k < levels.size(); ++k) {
+            auto& level = *levels[k];
+            level.sampleRate = sampleRate / (1 << level.decimationAsPowerOf2);
+            level.maxBlockSize = levelBlockSize;
+            level.processor->setAdditionalLatency(0);
+            level.processor->prepare(level.sampleRate, levelBlockSize, numInputChannels, numOutputChannels);
+
+            if (k + 1 < levels.size()) {
+                jassert(levels[k + 1]->decimationAsPowerOf2 >= level.decimationAsPowerOf2);
+                level.factor = 1 << (levels[k + 1]->decimationAsPowerOf2 - level.decimationAsPowerOf2);
+                levelBlockSize = levelBlockSize / level.factor + 1;
+                prepareSplit(level, levelBlockSize);
+            }
+        }
+
+        alignLatencies(numInputChannels, numOutputChannels);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& level : levels) {
+            level->history.clear();
+            level->lowInputHistory.clear();
+            level->lowOutputHistory.clear();
+            level->phase = 0;
+            level->processor->reset();
+        }
+    }
+
+    /** Records the timing into telemetry (see ProcessorTelemetry), one record per call of process() for all
+        bands together, or stops recording for a nullptr. Don't call this while processing */
+    void setTelemetry(ProcessorTelemetry* telemetryToUse)
+    {
+        telemetry = telemetryToUse;
+        for (auto& processor : processors)
+            processor->setTelemetry(telemetryToUse);
+    }
+
+    void process(const dsp::ProcessContextReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::ProcessContextNonReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
+    {
+        const auto numSamples = (int)inputBlock.getNumSamples();
+        const ProcessorTelemetry::ScopedCallback callbackTiming(telemetry, numSamples);
+        const auto numChIn = (size_t)jmin((int)inputBlock.getNumChannels(), numInpChannel);
+        const auto numChOut = (size_t)jmin((int)outputBlock.getNumChannels(), numOutChannel);
+
+        // the buffers of the levels hold the blocks of the size given to prepare()
+        for (int start = 0; start < numSamples; start += maxBlockSize) {
+            const auto length = (size_t)jmin(maxBlockSize, numSamples - start);
+            auto outputRun = outputBlock.getSubsetChannelBlock(0, numChOut).getSubBlock((size_t)start, length);
+            processLevel(0, inputBlock.getSubsetChannelBlock(0, numChIn).getSubBlock((size_t)start, length), outputRun);
+        }
+
+        for (auto ch = numChOut; ch < outputBlock.getNumChannels(); ++ch)
+            FloatVectorOperations::clear(outputBlock.getChannelPointer(ch), numSamples);
+    }
+
+private:
+    /** A band, and for all but the lowest one, the split from the next lower band */
+    struct Level {
+        ProcessorType* processor = nullptr;
+        int decimationAsPowerOf2 = 0;
+        float crossoverFrequency = 0.0f;
+        double sampleRate = 0.0;
+        int maxBlockSize = 0;
+
+        // the split: lowpass of filterLength taps, decimation by factor, and its polyphase form for the
+        // interpolation, numPhaseTaps per phase
+        int factor = 1;
+        int filterLength = 0;
+        int numPhaseTaps = 0;
+        std::vector<SampleType> lowpass;
+        std::vector<SampleType> interpolation;
+        int phase = 0;
+
+        MirroredRingBuffer<SampleType> history;
+        MirroredRingBuffer<SampleType> lowInputHistory;
+        MirroredRingBuffer<SampleType> lowOutputHistory;
+        AudioBuffer<SampleType> lowInput;
+        AudioBuffer<SampleType> lowOutput;
+        AudioBuffer<SampleType> band;
+        AudioBuffer<SampleType> bandOutput;
+    };
+
+    /** Designs the crossover lowpass of a level (Kaiser windowed sinc, -6 dB at the crossover) and allocates its buffers */
+    void prepareSplit(Level& level, const int lowBlockSize)
+    {
+        // the transition ends at the Nyquist frequency of the lower band, so the decimation doesn't alias,
+        // but is at most as wide as the crossover frequency, which keeps the low band below it
+        const double crossover = level.crossoverFrequency;
+        const double lowNyquist = 0.5 * level.sampleRate / level.factor;
+        jassert(crossover < lowNyquist); // decimated too far for this crossover
+        const double transition = jmax(jmin(2.0 * (lowNyquist - crossover), crossover), 0.5 * crossover);
+
+        // 80 dB stopband attenuation
+        const double attenuation = 80.0;
+        const double beta = 0.1102 * (attenuation - 8.7);
+        const int order = (int)std::ceil((attenuation - 8.0) / (2.285 * MathConstants<double>::twoPi * transition / level.sampleRate));
+        level.filterLength = 2 * ((order + 1) / 2) + 1;
+
+        std::vector<double> window((size_t)level.filterLength);
+        dsp::WindowingFunction<double>::fillWindowingTables(window.data(), (size_t)level.filterLength,
+                                                            dsp::WindowingFunction<double>::kaiser, false, beta);
+
+        const double normalisedCutoff = 2.0 * crossover / level.sampleRate;
+        const int centre = level.filterLength / 2;
+        std::vector<double> taps((size_t)level.filterLength);
+        double sum = 0.0;
+        for (int i = 0; i < level.filterLength; ++i) {
+            const double x = MathConstants<double>::pi * normalisedCutoff * (i - centre);
+            taps[(size_t)i] = window[(size_t)i] * (i == centre ? 1.0 : std::sin(x) / x);
+            sum += taps[(size_t)i];
+        }
+
+        level.lowpass.resize((size_t)level.filterLength);
+        for (int i = 0; i < level.filterLength; ++i)
+            level.lowpass[(size_t)i] = (SampleType)(taps[(size_t)i] / sum);
+
+        // phase p of the interpolation weights the low samples before the latest one, oldest first,
+        // with the taps p, p + factor, ... of the lowpass, times factor for the samples left out
+        level.numPhaseTaps = (level.filterLength + level.factor - 1) / level.factor;
+        level.interpolation.assign((size_t)(level.factor * level.numPhaseTaps), SampleType(0));
+        for (int p = 0; p < level.factor; ++p) {
+            for (int t = 0; t < level.numPhaseTaps; ++t) {
+                const int tap = p + (level.numPhaseTaps - 1 - t) * level.factor;
+                if (tap < level.filterLength)
+                    level.interpolation[(size_t)(p * level.numPhaseTaps + t)] = (SampleType)(level.factor * taps[(size_t)tap] / sum);
+            }
+        }
+
+        level.history.setSize(numInpChannel, level.filterLength + level.maxBlockSize);
+        level.lowInputHistory.setSize(numInpChannel, level.numPhaseTaps + lowBlockSize);
+        level.lowOutputHistory.setSize(numOutChannel, level.numPhaseTaps + lowBlockSize);
+        level.lowInput.setSize(numInpChannel, lowBlockSize);
+        level.lowOutput.setSize(numOutChannel, lowBlockSize);
+        level.band.setSize(numInpChannel, level.maxBlockSize);
+        level.bandOutput.setSize(numOutChannel, level.maxBlockSize);
+    }
+
+    /**
+     Delays the bands so they line up. The higher band of a split is the input delayed by the crossover filters,
+     minus the lower band, and this lower band is only cancelled if its two copies are delayed by the same time:
+     the latency of the processor of the higher band has to match the one of everything below, so the faster
+     side gets additional latency. The lowest band only gets some if a higher one is slower than all below it.
+     */
+    void alignLatencies(const int numInputChannels, const int numOutputChannels)
+    {
+        const int numLevels = (int)levels.size();
+        std::vector<int> additional((size_t)numLevels, 0);
+
+        for (;;) {
+            // the latency of everything from a level down, in samples of that level
+            int below = levels.back()->processor->getLatencySamples() + additional.back();
+            int lowestDeficit = 0;
+
+            for (int k = numLevels - 2; k >= 0; --k) {
+                auto& level = *levels[(size_t)k];
+                const int lowerLatency = level.factor * below;
+                const int ownLatency = level.processor->getLatencySamples();
+
+                additional[(size_t)k] = jmax(0, lowerLatency - ownLatency);
+                if (ownLatency > lowerLatency) {
+                    // the lowest band has to wait longer, in its own samples
+                    int samplesPerLowest = level.factor;
+                    for (int j = k + 1; j < numLevels - 1; ++j)
+                        samplesPerLowest *= levels[(size_t)j]->factor;
+                    lowestDeficit = jmax(lowestDeficit, (ownLatency - lowerLatency + samplesPerLowest - 1) / samplesPerLowest);
+                }
+
+                below = level.filterLength - 1 + lowerLatency;
+            }
+
+            if (lowestDeficit == 0) {
+                latencySamples = below;
+                break;
+            }
+
+            additional.back() += lowestDeficit;
+        }
+
+        for (int k = 0; k < numLevels; ++k) {
+            if (additional[(size_t)k] > 0) {
+                auto& level = *levels[(size_t)k];
+                level.processor->setAdditionalLatency(additional[(size_t)k]);
+                level.processor->prepare(level.sampleRate, level.maxBlockSize, numInputChannels, numOutputChannels);
+            }
+        }
+    }
+
+    void processLevel(const int k, const dsp::AudioBlock<const SampleType>& input, dsp::AudioBlock<SampleType>& output)
+    {
+        auto& level = *levels[(size_t)k];
+        const auto numSamples = (int)input.getNumSamples();
+        const auto numChIn = (int)input.getNumChannels();
+        const auto numChOut = (int)output.getNumChannels();
+
+        if (k + 1 == (int)levels.size()) {
+            level.processor->process(input, output);
+            return;
+        }
+
+        // the input is kept first, as input and output may share memory (replacing context)
+        for (int ch = 0; ch < numChIn; ++ch)
+            level.history.write(ch, input.getChannelPointer((size_t)ch), numSamples);
+        level.history.advance(numSamples);
+
+        // the samples where the phase is 0 are decimated into the lower band
+        const int firstLow = (level.factor - level.phase) % level.factor;
+        const int numLow = firstLow < numSamples ? (numSamples - 1 - firstLow) / level.factor + 1 : 0;
+        for (int ch = 0; ch < numChIn; ++ch) {
+            SampleType* low = level.lowInput.getWritePointer(ch);
+            for (int j = 0; j < numLow; ++j)
+                low[j] = dot(getFilterWindow(level, ch, firstLow + j * level.factor, numSamples), level.lowpass.data(), level.filterLength);
+        }
+
+        const auto lowInput = dsp::AudioBlock<SampleType>(level.lowInput).getSubsetChannelBlock(0, (size_t)numChIn).getSubBlock(0, (size_t)numLow);
+        auto lowOutput = dsp::AudioBlock<SampleType>(level.lowOutput).getSubsetChannelBlock(0, (size_t)numChOut).getSubBlock(0, (size_t)numLow);
+        if (numLow > 0)
+            processLevel(k + 1, lowInput, lowOutput);
+
+        for (int ch = 0; ch < numChIn; ++ch)
+            level.lowInputHistory.write(ch, level.lowInput.getReadPointer(ch), numLow);
+        level.lowInputHistory.advance(numLow);
+        for (int ch = 0; ch < numChOut; ++ch)
+            level.lowOutputHistory.write(ch, level.lowOutput.getReadPointer(ch), numLow);
+        level.lowOutputHistory.advance(numLow);
+
+        // the own band: the input delayed by the crossover filters, minus the lower band
+        for (int ch = 0; ch < numChIn; ++ch) {
+            SampleType* band = level.band.getWritePointer(ch);
+            for (int n = 0; n < numSamples; ++n)
+                band[n] = getFilterWindow(level, ch, n, numSamples)[0] - interpolate(level, level.lowInputHistory, ch, n, firstLow, numLow);
+        }
+
+        const auto bandInput = dsp::AudioBlock<SampleType>(level.band).getSubsetChannelBlock(0, (size_t)numChIn).getSubBlock(0, (size_t)numSamples);
+        auto bandOutput = dsp::AudioBlock<SampleType>(level.bandOutput).getSubsetChannelBlock(0, (size_t)numChOut).getSubBlock(0, (size_t)numSamples);
+        level.processor->process(bandInput, bandOutput);
+
+        for (int ch = 0; ch < numChOut; ++ch) {
+            const SampleType* bandSamples = level.bandOutput.getReadPointer(ch);
+            SampleType* out = output.getChannelPointer((size_t)ch);
+            for (int n = 0; n < numSamples; ++n)
+                out[n] = bandSamples[n] + interpolate(level, level.lowOutputHistory, ch, n, firstLow, numLow);
+        }
+
+        level.phase = (level.phase + numSamples) % level.factor;
+    }
+
+    /** The filterLength input samples ending at sample n of the current block, oldest first */
+    static const SampleType* getFilterWindow(const Level& level, const int ch, const int n, const int numSamples)
+    {
+        return level.history.getLatestSamples(ch, level.filterLength + numSamples - 1 - n);
+    }
+
+    /** Sample n of the current block of the lower band in ring, interpolated up to the rate of the level */
+    static SampleType interpolate(const Level& level, const MirroredRingBuffer<SampleType>& ring, const int ch, const int n,
+                                  const int firstLow, const int numLow)
+    {
+        // the low samples of the block up to n, and the phase of n after the latest of them
+        const int numLowUpToN = n >= firstLow ? (n - firstLow) / level.factor + 1 : 0;
+        const int p = (level.phase + n) % level.factor;
+        const SampleType* lowSamples = ring.getLatestSamples(ch, level.numPhaseTaps + numLow - numLowUpToN);
+        return dot(lowSamples, level.interpolation.data() + p * level.numPhaseTaps, level.numPhaseTaps);
+    }
+
+    static SampleType dot(const SampleType* a, const SampleType* b, const int num) noexcept
+    {
+        // independent partial sums, which the compiler can keep in one SIMD register
+        SampleType sums[8] = {};
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+            for (int lane = 0; lane < 8; ++lane)
+                sums[lane] += a[i + lane] * b[i + lane];
+
+        SampleType sum = ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+        for (; i < num; ++i)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    // from the lowest band up, as passed to the constructor
+    std::vector<std::unique_ptr<ProcessorType>> processors;
+    // from the highest band down, in processing order
+    std::vector<std::unique_ptr<Level>> levels;
+
+    int numInpChannel = 0;
+    int numOutChannel = 0;
+    int maxBlockSize = 0;
+    int latencySamples = 0;
+
+    ProcessorTelemetry* telemetry = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(MultiResolutionFftProcessor)
+};
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    OfflineFrameRenderer.h
+    Created: 19 Oct 2026 5:40:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelThreadPool.h"
+
+using namespace juce;
+
+/**
+ Renders a whole buffer through an OverlapAddFftProcessorBase subclass on all cores.
+
+ Offline, the hops don't have to follow each other: the output is cut into ranges of whole hops, and the ranges
+ are rendered in parallel, each thread with its own processor. A range starts its processor on the hop grid of a
+ continuous render, a guard of fftSize samples before its first output sample, so every frame reaching the range
+ is built from the same input as in one pass over the file, and only the samples of the range are kept. A range
+ therefore recomputes the fftSize / hopSize frames it shares with the range before it, and the ranges are
+ written into the output in place, without overlapping each other.
+
+ The processor declares how its frames depend on each other (OverlapAddFftProcessorBase::setFrameDependency()):
+ stateless processors need just the guard, processors with FrameDependency::warmUp start getNumWarmUpFrames()
+ frames earlier still, and sequential ones are rendered in one range, on one thread. The output matches a
+ continuous render up to rounding (and up to the tolerance of the warm-up).
+ @code
+ OfflineFrameRenderer<SpectralDynamicProcessor> renderer ([] { return std::make_unique<SpectralDynamicProcessor> (10, 3); });
+ renderer.render (input, output, 48000.0);
+ @endcode
+ */
+template <typename ProcessorType>
+class OfflineFrameRenderer {
+public:
+    using SampleType = typename ProcessorType::SampleType;
+    using ProcessorFactory = std::function<std::unique_ptr<ProcessorType>()>;
+
+    /**
+     @param processorFactory creates a processor with all settings applied, called once per thread in render()
+     @param numThreads the number of threads including the one calling render()
+     */
+    OfflineFrameRenderer(ProcessorFactory processorFactory, const int numThreads = SystemStats::getNumCpus())
+        : createProcessor(std::move(processorFactory))
+        , numRenderThreads(jmax(1, numThreads))
+    {
+    }
+
+    /**
+     Processes input into output, aligned: the latency of the processor is compensated, so output[n] belongs to
+     input[n], and output gets the size of input. The tail after the end of the input is cut off.
+     @param blockSize the block size each processor is prepared for and called with
+     */
+    void render(const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const double sampleRate, const int blockSize = 4096)
+    {
+        const int numChannels = input.getNumChannels();
+        const int length = input.getNumSamples();
+        output.setSize(numChannels, length, false, false, true);
+
+        // the first processor tells the others how far to reach back, its settings are the ones of all
+        auto first = createProcessor();
+        first->prepare(sampleRate, blockSize, numChannels, numChannels);
+
+        const int hopSize = first->getHopSize();
+        const bool sequential = first->getFrameDependency() == OverlapAddFftProcessorTypes::FrameDependency::sequential;
+        guardLength = first->getFftSize() + first->getNumWarmUpFrames() * hopSize;
+
+        // a few ranges per thread keep the threads busy until the end, but a range should be long compared to its guard
+        const int numThreads = sequential ? 1 : jmax(1, jmin(numRenderThreads, length / (4 * guardLength)));
+        if (numThreads > 1) {
+            const int numRanges = 4 * numThreads;
+            rangeLength = roundUp(jmax((length + numRanges - 1) / numRanges, 4 * guardLength), hopSize);
+        }
+        else {
+            rangeLength = roundUp(jmax(length, 1), hopSize);
+        }
+
+        const int numRanges = (length + rangeLength - 1) / rangeLength;
+        nextRange.store(0);
+
+        processors.clear();
+        scratch.clear();
+        for (int i = 0; i < numThreads; ++i) {
+            if (i > 0) {
+                processors.push_back(createProcessor());
+                processors.back()->prepare(sampleRate, blockSize, numChannels, numChannels);
+            }
+            else {
+                processors.push_back(std::move(first));
+            }
+
+            scratch.push_back(std::make_unique<AudioBuffer<SampleType>>(numChannels, blockSize));
+        }
+
+        // every task owns a processor and takes ranges until none are left, wherever the pool runs it
+        auto task = [this, &input, &output, numRanges](const int taskIndex) {
+            for (int range = nextRange.fetch_add(1); range < numRanges; range = nextRange.fetch_add(1))
+                renderRange(*processors[(size_t)taskIndex], *scratch[(size_t)taskIndex], input, output, range);
+        };
+
+        // offline, the workers run at normal priority beside the rest of the system
+        threads.start(numThreads, ChannelThreadPool::Priority::normal);
+        threads.run(numThreads, task);
+        threads.stop();
+    }
+
+private:
+    /** Renders the output samples [range * rangeLength, (range + 1) * rangeLength) with a fresh processor */
+    void renderRange(ProcessorType& processor, AudioBuffer<SampleType>& block, const AudioBuffer<SampleType>& input,
+                     AudioBuffer<SampleType>& output, const int range)
+    {
+        const int length = input.getNumSamples();
+        const int latency = processor.getLatencySamples();
+        const int rangeStart = range * rangeLength;
+        const int rangeEnd = jmin(rangeStart + rangeLength, length);
+
+        // ranges and guards are whole hops, so the frames of the fresh processor are the ones of a continuous render.
+        // Before sample 0, a continuous render sees silence as well, so the first range needs no guard
+        const int end = rangeEnd + latency;
+        int position = jmax(0, rangeStart - guardLength);
+
+        processor.reset();
+
+        while (position < end) {
+            const int numSamples = jmin(block.getNumSamples(), end - position);
+            const int numFromInput = jlimit(0, numSamples, length - position);
+
+            for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+                if (numFromInput > 0)
+                    FloatVectorOperations::copy(block.getWritePointer(ch), input.getReadPointer(ch, position), numFromInput);
+                FloatVectorOperations::clear(block.getWritePointer(ch, numFromInput), numSamples - numFromInput);
+            }
+
+            auto audioBlock = dsp::AudioBlock<SampleType>(block).getSubBlock(0, (size_t)numSamples);
+            processor.process(dsp::ProcessContextReplacing<SampleType>(audioBlock));
+
+            // keep what belongs to the range, the processed sample at position + i is the output of input sample position + i - latency
+            const int keepFrom = jmax(position, rangeStart + latency);
+            if (keepFrom < position + numSamples) {
+                for (int ch = 0; ch < block.getNumChannels(); ++ch)
+                    FloatVectorOperations::copy(output.getWritePointer(ch, keepFrom - latency), block.getReadPointer(ch, keepFrom - position),
+                                                position + numSamples - keepFrom);
+            }
+
+            position += numSamples;
+        }
+    }
+
+    static int roundUp(const int value, const int multiple) { return (value + multiple - 1) / multiple * multiple; }
+
+    ProcessorFactory createProcessor;
+    const int numRenderThreads;
+
+    std::vector<std::unique_ptr<ProcessorType>> processors;
+    std::vector<std::unique_ptr<AudioBuffer<SampleType>>> scratch;
+    ChannelThreadPool threads;
+
+    int guardLength = 0;
+    int rangeLength = 0;
+    std::atomic<int> nextRange { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(OfflineFrameRenderer)
+};
@@ -11,15 +11,85 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MirroredRingBuffer.h"
+#include "FftWindow.h"
+#include "FrameQueue.h"
+#include "ChannelThreadPool.h"
+#include "WorkerWakeup.h"
+#include "FftBackend.h"
+#include "ProcessorTelemetry.h"
 
 using namespace juce;
 
+/** The enums of OverlapAddFftProcessorBase, shared by all its instantiations */
+struct OverlapAddFftProcessorTypes {
+    /** Where processFrameInBuffer() runs */
+    enum class FrameScheduling {
+        /** on the audio thread, as soon as a frame is complete */
+        audioThread,
+        /** on a worker thread, handed over through a wait-free frame queue. The result of each frame is
+            collected one hop later, which adds one hop to the latency, but moves the FFT cost off the audio thread */
+        workerThread,
+        /** on the audio thread, but spread over the hop following the frame: after every run of samples, the
+            share of channels due by then is processed, and the frame is overlap-added one hop later. Adds one hop
+            to the latency, and brings the worst-case callback cost close to the average when blocks are shorter
+            than a hop. Calls processChannelFrame() instead of processFrameInBuffer(), so it only spreads across
+            channels: a mono frame is still processed in one go. */
+        loadBalanced
+    };
+
+    /** How the frames are laid out for processFrameInBuffer() */
+    enum class FftBufferLayout {
+        /** one channel of `fftInOutBuffer` per channel */
+        perChannel,
+        /** groups of FftBackend::batchSize channels interleaved sample by sample, one group per
+            getInterleavedFrames(group), ready for fft.performRealOnlyForwardTransformBatch(). Only used with
+            audioThread and workerThread scheduling, and never spread over the channel threads */
+        channelInterleaved
+    };
+
+    /** How processSpectrum() gets the bins of each channel */
+    enum class SpectrumFormat {
+        /** processSpectrum() isn't used, the frame callbacks work on the time domain frames */
+        none,
+        /** real and imaginary part */
+        cartesian,
+        /** magnitude and phase */
+        polar
+    };
+
+    /** How the frames depend on each other, which decides how OfflineFrameRenderer can split a file */
+    enum class FrameDependency {
+        /** every frame only depends on its own input window */
+        stateless,
+        /** the processor keeps state across frames, but forgets it after getNumWarmUpFrames() frames (exactly
+            or closely enough), so processing can start fresh that many frames early and give the same output */
+        warmUp,
+        /** every frame may depend on all frames before it, so they can only be processed in order */
+        sequential
+    };
+};
+
 /**
  This processor takes care of buffering input and output samples for your FFT processing.
  With fttSizeAsPowerOf2 and hopSizeDividerAsPowerOf2 the fftSize and hopSize can be specifiec.
  Inherit from this class and override the processFrameInBuffer() function in order to
- implement your processing. You can also override the `createWindow()` method to use
- another window (default: Hann window).
+ implement your processing, or processChannelFrame() if every channel is processed on its own. Pass a FftWindowType to the constructor or call setWindowType()
+ to use another window (default: Hann window). With many channels, setFftBufferLayout(FftBufferLayout::channelInterleaved)
+ hands the frames over in groups of FftBackend::batchSize channels, which fft.performRealOnlyForwardTransformBatch()
+ transforms at once, one channel per SIMD lane. Processors that only work on the spectra can call setSpectrumFormat()
+ and override processSpectrum() instead; the transforms are then done for them.
+
+ SampleType is the type of the audio going in and out, and of the overlap-add; FrameType the one of the frames,
+ the window and the transforms. OverlapAddFftProcessor processes float, DoubleOverlapAddFftProcessor double,
+ and MixedOverlapAddFftProcessor takes double audio and accumulates the overlap-add in double, but runs the
+ transforms in float. The types are resolved at compile time, so the inner loops don't branch on them.
+
+ The frame callbacks (processFrameInBuffer(), processChannelFrame(), processSpectrum()) and createWindow() are
+ resolved statically: Derived is the class that implements them (CRTP), and a member of the same name in Derived
+ replaces the default of this class, so the callback can be inlined into the hop loop. Derived has to declare
+ them public or befriend this class. BasicOverlapAddFftProcessor (OverlapAddFftProcessor, ...) is Derived for
+ processors that override them as virtual functions instead.
  @code
  class MyProcessor : public OverlappingFFTProcessor
  {
@@ -40,16 +110,24 @@ using namespace juce;
  };
  */
 
-class OverlapAddFftProcessor {
+template <typename Derived, typename Sample, typename Frame = Sample>
+class OverlapAddFftProcessorBase : public OverlapAddFftProcessorTypes {
 public:
+    using SampleType = Sample;
+    using FrameType = Frame;
+
     /** Constructor
      @param fftSizeAsPowerOf2 defines the fftSize as a power of 2: fftSize = 2^fftSizeAsPowerOf2
      @param hopSizeDividerAsPowerOf2 defines the hopSize as a fraction of fftSize: hopSize = fftSize / (2^hopSizeDivider)
+     @param windowType the window used for analysis and synthesis
+     @param fftBackendType the FFT engine behind `fft`, by default the one set with OVERLAP_ADD_FFT_BACKEND
      */
-    OverlapAddFftProcessor(const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1)
-        : fft(fftSizeAsPowerOf2)
+    OverlapAddFftProcessorBase(const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1, const FftWindowType windowType = FftWindowType::hann,
+                               const FftBackendType fftBackendType = (FftBackendType)OVERLAP_ADD_FFT_BACKEND)
+        : fft(fftSizeAsPowerOf2, fftBackendType)
         , fftSize(1 << fftSizeAsPowerOf2)
         , hopSize(fftSize >> hopSizeDividerAsPowerOf2)
+        , windowType(windowType)
     {
         // make sure you have at least an overlap of 50%
         jassert(hopSizeDividerAsPowerOf2 > 0);
@@ -59,394 +137,816 @@ public:
 
         DBG("Overlapping FFT Processor created with fftSize: " << fftSize << " and hopSize: " << hopSize);
 
-        // gInputBuffer.resize(gBufferSize);
-        // gOutputBuffer.resize(gBufferSize);
+        // the window is created in prepare(), Derived isn't constructed yet
+        subFrameSize = fftSize;
+        requestedSubFrameSize = fftSize;
+    }
 
-        // create window
-        window.resize(fftSize);
-        createWindow();
+    ~OverlapAddFftProcessorBase()
+    {
+        // Derived has to stop the worker in its own destructor, see stopFrameWorker()
+        jassert(frameWorker == nullptr);
+        stopFrameWorker();
+    }
 
-        // don`t change the size of the window during createWindow()!
-        jassert(window.size() == fftSize);
+    /**
+     Clears all buffered audio and restarts the timeline, as after prepare(). Doesn't allocate or lock, so it can be
+     called from the audio thread, except with FrameScheduling::workerThread: the frames still in flight on the
+     worker thread are waited for and dropped, which blocks for up to the processing time of a frame.
+     */
+    void reset()
+    {
+        if (frameWorker != nullptr) {
+            while (frameQueue.getNumInFlight() > 0) {
+                while (! frameQueue.isOldestCompleted())
+                    Thread::yield();
+                frameQueue.release();
+            }
+        }
+
+        gInputBuffer.clear();
+        gOutputBuffer.clear();
+        gHopCounter = 0;
+        gOutputBufferWritePointer = latencySamples + hopSize;
+        pendingFrame = {};
+    }
+
+    /** Changes the analysis and synthesis window, takes effect with the next call of prepare(). The window is only
+        rebuilt there, as the audio thread and the frame worker read it while processing.
+     @param kaiserBeta shape parameter, only used for FftWindowType::kaiser
+     */
+    void setWindowType(const FftWindowType newWindowType, const float newKaiserBeta = 8.0f)
+    {
+        windowType = newWindowType;
+        kaiserBeta = newKaiserBeta;
     }
 
-    virtual ~OverlapAddFftProcessor() { }
+    /**
+     Switches to the low-latency mode: the analysis window keeps spanning the whole frame, but only the last
+     subFrameSize samples of every frame are synthesised (see FftWindow::createLowLatency()), so the latency drops
+     from fftSize to subFrameSize. Replaces the window type while active. Takes effect with the next call of
+     prepare(), together with the latency and the window that go with it.
+     @param newSubFrameSize a power of two from 2 * hopSize to fftSize, fftSize turns the mode off
+     */
+    void setSubFrameSize(const int newSubFrameSize)
+    {
+        jassert(isPowerOfTwo(newSubFrameSize));
+        requestedSubFrameSize = jlimit(2 * hopSize, fftSize, newSubFrameSize);
+    }
 
-    void reset() { }
+    int getFftSize() const { return fftSize; }
+    int getHopSize() const { return hopSize; }
+    /** The subFrameSize in use, set with setSubFrameSize() (valid after prepare()) */
+    int getSubFrameSize() const { return subFrameSize; }
 
-    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    /** Chooses where the frames are processed, takes effect with the next call of prepare() */
+    void setFrameScheduling(const FrameScheduling newFrameScheduling)
     {
-		gOutputBufferWritePointer = fftSize + 2 * hopSize;
+        frameScheduling = newFrameScheduling;
+    }
 
-        // this->sampleRate = sampleRate;
-        numInpChannel = numInputChannels;
-        numOutChannel = numOutputChannels;
+    FrameScheduling getFrameScheduling() const { return frameScheduling; }
+
+    /**
+     Spreads the channels of each frame over a pool of threads, takes effect with the next call of prepare().
+     This calls processChannelFrame() for every channel instead of processFrameInBuffer(), so only use it
+     with processors that override processChannelFrame().
+     @param numThreads the number of threads including the one calling process(), 1 turns it off
+     @param minNumChannels frames with fewer channels are processed serially, as waking the pool wouldn't pay off
+     */
+    void setParallelChannelProcessing(const int numThreads, const int minNumChannels = 8)
+    {
+        numChannelThreads = numThreads;
+        minNumChannelsForThreads = minNumChannels;
+    }
 
-        // const int bufferSize = maximumBlockSize;
+    /**
+     The bins 0 ... fftSize / 2 of a range of channels, as split arrays. The processor owns the transforms:
+     it fills the view before processSpectrum() and transforms every channel back afterwards, unless it was
+     marked unchanged.
+     */
+    class SpectrumView {
+    public:
+        int getNumChannels() const noexcept { return numChannels; }
+        int getNumBins() const noexcept { return numBins; }
+
+        /** The channel of the processor that channel 0 of this view refers to */
+        int getFirstChannel() const noexcept { return firstChannel; }
+
+        SpectrumFormat getFormat() const noexcept { return format; }
+
+        /** Real parts (SpectrumFormat::cartesian) */
+        FrameType* getReal(const int ch) const noexcept { jassert(format == SpectrumFormat::cartesian); return first->getWritePointer(firstChannel + ch); }
+        /** Imaginary parts (SpectrumFormat::cartesian) */
+        FrameType* getImag(const int ch) const noexcept { jassert(format == SpectrumFormat::cartesian); return second->getWritePointer(firstChannel + ch); }
+        /** Magnitudes (SpectrumFormat::polar) */
+        FrameType* getMagnitude(const int ch) const noexcept { jassert(format == SpectrumFormat::polar); return first->getWritePointer(firstChannel + ch); }
+        /** Phases in radians (SpectrumFormat::polar) */
+        FrameType* getPhase(const int ch) const noexcept { jassert(format == SpectrumFormat::polar); return second->getWritePointer(firstChannel + ch); }
+
+        /** Tells the processor that a channel wasn't modified, so its inverse transform can be skipped */
+        void setUnchanged(const int ch) noexcept { changed[firstChannel + ch] = 0; }
+
+    private:
+        friend class OverlapAddFftProcessorBase;
+
+        AudioBuffer<FrameType>* first = nullptr;
+        AudioBuffer<FrameType>* second = nullptr;
+        uint8* changed = nullptr;
+        int firstChannel = 0;
+        int numChannels = 0;
+        int numBins = 0;
+        SpectrumFormat format = SpectrumFormat::none;
+    };
 
-        inputAudioBufferLenght = fftSize * 2;
-        // inpBufferWritePointer = 0;
+    /**
+     Lets the processor run the FFTs and hand the spectra to processSpectrum(), instead of leaving the time
+     domain frames to processFrameInBuffer() or processChannelFrame(). Don't call this while processing.
+     */
+    void setSpectrumFormat(const SpectrumFormat newSpectrumFormat)
+    {
+        spectrumFormat = newSpectrumFormat;
+    }
 
-        // notYetUsedAudioData.setSize (numInpChannel, fftSize);
+    /** Chooses the layout of the frames handed to processFrameInBuffer(), takes effect with the next call of prepare() */
+    void setFftBufferLayout(const FftBufferLayout newFftBufferLayout)
+    {
+        fftBufferLayout = newFftBufferLayout;
+    }
 
-        const auto maxCh = jmax(numInpChannel, numOutChannel);
-        fftInOutBuffer.setSize(maxCh, fftSize);
-		fftInOutBuffer.clear();
+    SpectrumFormat getSpectrumFormat() const { return spectrumFormat; }
+
+    /** Delays the output by some more samples, e.g. to align processors with different latencies.
+        Takes effect with the next call of prepare(). */
+    void setAdditionalLatency(const int numSamples)
+    {
+        additionalLatency = jmax(0, numSamples);
+    }
+
+    /**
+     Lets the processor take its frames from a ring buffer shared with other processors instead of an own one,
+     takes effect with the next call of prepare(). The owner of the ring writes and advances it, then calls
+     processSharedInputRun() with runs that don't cross the next hop of this processor (see getSamplesToNextHop()).
+     @param sharedInputRing a ring holding at least fftSize samples, or nullptr to use an own one again
+     */
+    void setSharedInput(const MirroredRingBuffer<SampleType>* sharedInputRing)
+    {
+        sharedInput = sharedInputRing;
+    }
+
+    /** Records the timing of every callback into telemetry (see ProcessorTelemetry), or stops recording for a
+        nullptr. Don't call this while processing; costs nothing unless OVERLAP_ADD_FFT_TELEMETRY is set. */
+    void setTelemetry(ProcessorTelemetry* telemetryToUse)
+    {
+        telemetry = telemetryToUse;
+    }
+
+    /** The number of samples until the next frame is due */
+    int getSamplesToNextHop() const { return hopSize - gHopCounter; }
+
+    /** Reads the output of a run whose input is already in the shared ring (see setSharedInput()),
+        and processes a frame if one is due. */
+    void processSharedInputRun(dsp::AudioBlock<SampleType>& outputBlock, const int numChIn)
+    {
+        const auto numSamples = (int)outputBlock.getNumSamples();
+        jassert(sharedInput != nullptr && numSamples <= getSamplesToNextHop());
+        const ProcessorTelemetry::ScopedCallback callbackTiming(telemetry, numSamples);
+
+        const auto numChOut = jmin(static_cast<int>(outputBlock.getNumChannels()), numOutChannel);
+        processOutputRun(outputBlock, 0, numSamples, jmin(numChIn, numInpChannel), numChOut);
 
-        // const int k = floor (1.0f + ((float) (bufferSize - 1)) / hopSize);
-        // const int M = k * hopSize + (fftSize - hopSize);
+		for (int ch = numChOut; ch < outputBlock.getNumChannels(); ++ch)
+			FloatVectorOperations::clear(outputBlock.getChannelPointer(ch), numSamples);
+    }
+
+    /** Returns the delay in samples between input and output (valid after prepare()) */
+    int getLatencySamples() const { return latencySamples; }
+
+    /** How the frames depend on each other (valid after prepare()), see setFrameDependency() */
+    FrameDependency getFrameDependency() const { return frameDependency; }
+
+    /** The number of frames a FrameDependency::warmUp processor needs to forget its state (valid after prepare()) */
+    int getNumWarmUpFrames() const { return frameDependency == FrameDependency::warmUp ? numWarmUpFrames : 0; }
 
-        outputBuffer.setSize(numOutChannel, inputAudioBufferLenght);
-        outputBuffer.clear();
+    /** Returns how long the output can go on after the input has stopped (valid after prepare()): the last frame
+        holding an input sample is synthesised up to fftSize samples later, and then delayed by the latency */
+    int getTailLengthSamples() const { return latencySamples + fftSize; }
+
+    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        stopFrameWorker();
+        channelThreads.start(numChannelThreads);
+        subFrameSize = requestedSubFrameSize;
+        derived().createWindow();
 
-        // int offset = 0;
-        // while (offset < fftSize)
-        //     offset += bufferSize;
+        // a frame is overlap-added as soon as its hop is complete, and only its last subFrameSize samples
+        // reach the output. Frames processed by the worker or spread over a hop are collected one hop late
+        latencySamples = subFrameSize;
+        if (frameScheduling != FrameScheduling::audioThread)
+            latencySamples += hopSize;
+        latencySamples += additionalLatency;
 
-        outputOffset = fftSize;
+		gOutputBufferWritePointer = latencySamples + hopSize;
+
+        this->sampleRate = sampleRate;
+        numInpChannel = numInputChannels;
+        numOutChannel = numOutputChannels;
+
+        const auto maxCh = jmax(numInpChannel, numOutChannel);
+        // the real-only transforms work in place on 2 * fftSize values per channel
+        fftInOutBuffer.setSize(maxCh, 2 * fftSize);
+		fftInOutBuffer.clear();
 
-		const int gBufferSize = 16384;
-        gInputBuffer.setSize(numInputChannels, gBufferSize);
-		gOutputBuffer.setSize(numInputChannels, gBufferSize);
-		gInputBuffer.clear();
-		gOutputBuffer.clear();
+        // the channel-interleaved frames are processed by processFrameInBuffer() only
+        jassert(fftBufferLayout == FftBufferLayout::perChannel || frameScheduling != FrameScheduling::loadBalanced);
+        numInterleavedGroups = fftBufferLayout == FftBufferLayout::channelInterleaved ? (maxCh + lanes - 1) / lanes : 0;
+        interleavedFftBuffer.allocate(numInterleavedGroups * 2 * fftSize * lanes, true);
+
+        spectrumWorkspace.setSize(maxCh, 2 * fftSize);
+        spectrumFirst.setSize(maxCh, fftSize / 2 + 1);
+        spectrumSecond.setSize(maxCh, fftSize / 2 + 1);
+        frameChanged.allocate((size_t)maxCh, false);
+        std::fill(frameChanged.get(), frameChanged.get() + maxCh, (uint8)1);
+
+		// the input only has to hold one frame, the output has to reach from the read position
+		// up to the end of the latest frame
+        gInputBuffer.setSize(sharedInput == nullptr ? numInpChannel : 0, fftSize);
+		gOutputBuffer.setSize(numOutChannel, gOutputBufferWritePointer);
+		inputRing = sharedInput != nullptr ? sharedInput : &gInputBuffer;
+
+		// restart the shared timeline of all channels
+		gHopCounter = 0;
+		pendingFrame = {};
+
+        if (frameScheduling == FrameScheduling::workerThread) {
+            // at most two frames are in flight: the one being processed and the one just submitted
+            frameQueue.setSize(4, maxCh, fftSize);
+            frameWorker = std::make_unique<FrameWorker>(*this);
+            startRealtimeWorker(*frameWorker);
+        }
     }
 
-    void process(const dsp::ProcessContextReplacing<float>& context)
+    void process(const dsp::ProcessContextReplacing<SampleType>& context)
     {
         process(context.getInputBlock(), context.getOutputBlock());
     }
 
-    void process(const dsp::ProcessContextNonReplacing<float>& context)
+    void process(const dsp::ProcessContextNonReplacing<SampleType>& context)
     {
         process(context.getInputBlock(), context.getOutputBlock());
     }
 
-    void process(const dsp::AudioBlock<const float>& inputBlock, dsp::AudioBlock<float>& outputBlock)
+    void process(const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
     {
-        const auto maxNumChannels = inputBlock.getNumChannels();
         const auto inputBlockLength = (int)inputBlock.getNumSamples();
-
-		for (int ch = 0; ch < maxNumChannels; ++ch)
+        const ProcessorTelemetry::ScopedCallback callbackTiming(telemetry, inputBlockLength);
+        const auto numChIn = jmin(static_cast<int>(inputBlock.getNumChannels()), numInpChannel);
+        const auto numChOut = jmin(static_cast<int>(outputBlock.getNumChannels()), numOutChannel);
+
+		// All channels share one timeline: the buffer pointers and the hop counter advance
+		// once per run, and every hop processes the frames of all channels together.
+		// Work in runs that end either at the end of the block or at the next hop,
+		// so every run can be moved with vector operations instead of sample by sample
+		int i = 0;
+		while (i < inputBlockLength)
 		{
-			for (int i = 0; i < inputBlockLength; i++)
-			{
-				float in = inputBlock.getSample(ch, i);
-
-				// Store the sample ("in") in a buffer for the FFT
-				// Increment the pointer and when full window has been 
-				// assembled, call process_fft()
-				// gInputBuffer[gInputBufferPointer++] = in;
-				gInputBuffer.setSample(ch, gInputBufferPointer, in);
-				gInputBufferPointer++;
-				if(gInputBufferPointer >= gBufferSize) {
-					// Wrap the circular buffer
-					// Notice: this is not the condition for starting a new FFT
-					gInputBufferPointer = 0;
-				}
-				
-				// Get the output sample from the output buffer
-				// float out = gOutputBuffer[gOutputBufferReadPointer];
-				float out = gOutputBuffer.getSample(ch, gOutputBufferReadPointer);
-				
-				
-				// Then clear the output sample in the buffer so it is ready for the next overlap-add
-				// gOutputBuffer[gOutputBufferReadPointer] = 0;
-				gOutputBuffer.setSample(ch, gOutputBufferReadPointer, 0);
-				
-				// Scale the output down by the scale factor, compensating for the overlap
-				out *= gScaleFactor;
-					
-				// Increment the read pointer in the output cicular buffer
-				gOutputBufferReadPointer++;
-				if(gOutputBufferReadPointer >= gBufferSize)
-					gOutputBufferReadPointer = 0;
-				
-				// Increment the hop counter and start a new FFT if we've reached the hop size
-				if(++gHopCounter >= hopSize) {
-					gHopCounter = 0;
-					
-					gCachedInputBufferPointer = gInputBufferPointer;
-					// Bela_scheduleAuxiliaryTask(gFftTask);
-					// Copy buffer into FFT input
-					for(int n = 0; n < fftSize; n++) {
-						// Use modulo arithmetic to calculate the circular buffer index
-						int circularBufferIndex = (gCachedInputBufferPointer + n - fftSize + gBufferSize) % gBufferSize;
-						// unwrappedBuffer[n] = inBuffer[circularBufferIndex] * gAnalysisWindowBuffer[n];
-						float sampleVal = gInputBuffer.getSample(ch, circularBufferIndex) * window.at(n);
-						fftInOutBuffer.setSample(ch, n, sampleVal); 
-					}
-            		processFrameInBuffer(maxNumChannels);
-
-					for(int n = 0; n < fftSize; n++) {
-						int circularBufferIndex = (gOutputBufferWritePointer + n - fftSize + gBufferSize) % gBufferSize;
-						// outBuffer[circularBufferIndex] += gFft.td(n) * gSynthesisWindowBuffer[n];
-						float sampleVal = gOutputBuffer.getSample(ch, circularBufferIndex) + fftInOutBuffer.getSample(ch, n) * window.at(n);
-						gOutputBuffer.setSample(ch, circularBufferIndex, sampleVal);
-					}
-
-					gOutputBufferWritePointer = (gOutputBufferWritePointer + hopSize) % gBufferSize;
-				}
-				outputBlock.setSample(ch, i, out);
-			}
+			const int numSamples = jmin(inputBlockLength - i, hopSize - gHopCounter);
+
+			// Store the new samples in the circular buffer for the FFT. This has to happen
+			// before reading the output as input and output may share memory (replacing context)
+			jassert(sharedInput == nullptr);
+			for (int ch = 0; ch < numChIn; ++ch)
+				gInputBuffer.write(ch, inputBlock.getChannelPointer(ch) + i, numSamples);
+
+			gInputBuffer.advance(numSamples);
+			processOutputRun(outputBlock, i, numSamples, numChIn, numChOut);
+			i += numSamples;
 		}
 
-        // if ((inpBufferWritePointer + inputBlockLength) <= inputAudioBufferLenght) {
-        //     for (int ch = 0; ch < numInpChannel; ++ch) {
-        //         FloatVectorOperations::copy(inputAudioBuffer.getWritePointer(ch, inpBufferWritePointer), // destination
-        //             inputBlock.getChannelPointer(ch), // source
-        //             inputBlockLength); // number of samples
-        //     }
-		// 	inpBufferWritePointer += inputBlockLength - 1;
-		// 	notYetUsedAudioDataCount += inputBlockLength;
-        // } 
-		// else {
-		// 	auto firstCopyLength = inputAudioBufferLenght - (inpBufferWritePointer + 1);
-        //     for (int ch = 0; ch < numInpChannel; ++ch) {
-        //         FloatVectorOperations::copy(inputAudioBuffer.getWritePointer(ch, inpBufferWritePointer), // destination
-        //             inputBlock.getChannelPointer(ch), // source
-        //             firstCopyLength); // number of samples
-        //     }
-		// 	inpBufferWritePointer = 0;
-		// 	auto secondCopyLength = inputBlockLength - firstCopyLength;
-        //     for (int ch = 0; ch < numInpChannel; ++ch) {
-        //         FloatVectorOperations::copy(inputAudioBuffer.getWritePointer(ch, inpBufferWritePointer), // destination
-        //             inputBlock.getChannelPointer(ch) + firstCopyLength - 1, // source
-        //             secondCopyLength); // number of samples
-        //     }
-		// 	inpBufferWritePointer += secondCopyLength - 1;
-		// 	notYetUsedAudioDataCount += inputBlockLength;
-        // }
-
-        // if (inpBufferWritePointer >= (inputAudioBufferLenght - 1)) {
-        //     inpBufferWritePointer -= (inputAudioBufferLenght - 1);
-        // }
-
-        // while (notYetUsedAudioDataCount >= fftSize) {
-        //     if ((inpBufferReadPointer + fftSize) <= inputAudioBufferLenght) {
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(fftInOutBuffer.getWritePointer(ch, 0), // destination
-		// 				inputAudioBuffer.getReadPointer(ch, inpBufferReadPointer), // source
-		// 				fftSize); // number of samples
-		// 		}
-		// 		inpBufferReadPointer += fftSize - 1;
-        //     }
-		// 	else {
-		// 		auto firstCopyLength = inputAudioBufferLenght - (inpBufferReadPointer + 1);
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(fftInOutBuffer.getWritePointer(ch, 0), // destination
-		// 				inputAudioBuffer.getReadPointer(ch, inpBufferReadPointer), // source
-		// 				firstCopyLength); // number of samples
-		// 		}
-		// 		inpBufferReadPointer = 0;
-		// 		auto secondCopyLength = fftSize - firstCopyLength;
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(fftInOutBuffer.getWritePointer(ch, firstCopyLength - 1), // destination
-		// 				inputAudioBuffer.getReadPointer(ch, inpBufferReadPointer), // source
-		// 				secondCopyLength); // number of samples
-		// 		}
-		// 		inpBufferReadPointer += secondCopyLength - 1;
-		// 	}
-
-		// 	if (inpBufferReadPointer >= (inputAudioBufferLenght - 1)) {
-		// 		inpBufferReadPointer -= (inputAudioBufferLenght - 1);
-		// 	}
-
-        //     notYetUsedAudioDataCount -= fftSize;
-        //     processFrameInBuffer(maxNumChannels);
-
-		// 	if ((outputOffset + fftSize) <= inputAudioBufferLenght) {
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(outputBuffer.getWritePointer(ch, 0), // destination
-		// 				fftInOutBuffer.getReadPointer(ch, 0), // source
-		// 				fftSize); // number of samples
-		// 		}
-		// 		outputOffset += fftSize - 1;
-        //     }
-		// 	else {
-		// 		auto firstCopyLength = inputAudioBufferLenght - (outputOffset + 1);
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(outputBuffer.getWritePointer(ch, outputOffset), // destination
-		// 				fftInOutBuffer.getReadPointer(ch, 0), // source
-		// 				firstCopyLength); // number of samples
-		// 		}
-		// 		outputOffset = 0;
-		// 		auto secondCopyLength = fftSize - firstCopyLength;
-		// 		for (int ch = 0; ch < numInpChannel; ++ch) {
-		// 			FloatVectorOperations::copy(outputBuffer.getWritePointer(ch, 0), // destination
-		// 				fftInOutBuffer.getReadPointer(ch, firstCopyLength - 1), // source
-		// 				secondCopyLength); // number of samples
-		// 		}
-		// 		outputOffset += secondCopyLength - 1;
-		// 	}
-
-		// 	if (outputOffset >= (inputAudioBufferLenght - 1)) {
-		// 		outputOffset -= (inputAudioBufferLenght - 1);
-		// 	}
-        //     // writeBackFrame();
-        // }
-
-        /* if data stored in  */
-
-        // const int initialNotYetUsedAudioDataCount = notYetUsedAudioDataCount;
-        // int notYetUsedAudioDataOffset = 0;
-        // int usedSamples = 0;
-
-        // // we've got some left overs, so let's use them together with the new samples
-        // while (notYetUsedAudioDataCount > 0 && notYetUsedAudioDataCount + inputBlockLength >= fftSize)
-        // {
-        //     // copy not yet used data into fftInOut buffer (with hann windowing)
-        //     for (int ch = 0; ch < numChIn; ++ch)
-        //     {
-        //         FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch), // destination
-        //                                          notYetUsedAudioData.getReadPointer (ch, notYetUsedAudioDataOffset), // source 1 (audio data)
-        //                                          window.data(), // source 2 (window)
-        //                                          notYetUsedAudioDataCount // number of samples
-        //                                         );
-
-        //         // fill up fftInOut buffer with new data (with hann windowing)
-        //         FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch, notYetUsedAudioDataCount), // destination
-        //                                          inputBlock.getChannelPointer (ch), // source 1 (audio data)
-        //                                          window.data() + notYetUsedAudioDataCount, // source 2 (window)
-        //                                          fftSize - notYetUsedAudioDataCount // number of samples
-        //                                         );
-        //     }
-
-        //     // process frame and buffer output
-        //     processFrameInBuffer (maxNumChannels);
-        //     writeBackFrame();
-
-        //     notYetUsedAudioDataOffset += hopSize;
-        //     notYetUsedAudioDataCount -= hopSize;
-        // }
-
-        // if (notYetUsedAudioDataCount > 0) // not enough new input samples to use all of the previous data
-        // {
-        //     for (int ch = 0; ch < numChIn; ++ch)
-        //     {
-        //         FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch),		//destination
-        //                                      notYetUsedAudioData.getReadPointer (ch, initialNotYetUsedAudioDataCount - notYetUsedAudioDataCount),	// source
-        //                                      notYetUsedAudioDataCount);		// number of samples
-        //         FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch, notYetUsedAudioDataCount),	//destination
-        //                                      inputBlock.getChannelPointer (ch) + usedSamples,	// source
-        //                                      inputBlockLength);		// number of samples
-        //     }
-        //     notYetUsedAudioDataCount += inputBlockLength;
-        // }
-        // else  // all of the previous data used
-        // {
-            ///int dataOffset = - notYetUsedAudioDataCount;
-            // int dataOffset = 0;
-
-            // while (inputBlockLength - dataOffset >= fftSize)
-            // {
-            //     for (int ch = 0; ch < numInpChannel; ++ch)
-            //     {
-            //         FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch),	// dest
-            //                                          inputBlock.getChannelPointer (ch) + dataOffset,	// src1
-            //                                          window.data(),		// src2
-        	// 										 fftSize);		// number of samples
-            //     }
-            //     processFrameInBuffer (maxNumChannels);
-            //     writeBackFrame();
-
-            //     dataOffset += hopSize;
-            // }
-
-            // int remainingSamples = inputBlockLength - dataOffset;
-            // if (remainingSamples > 0)
-            // {
-            //     for (int ch = 0; ch < numInpChannel; ++ch)
-            //     {
-            //         FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch),
-            //                                      inputBlock.getChannelPointer (ch) + dataOffset,
-            //                                      inputBlockLength - dataOffset);
-            //     }
-            // }
-            // notYetUsedAudioDataCount = remainingSamples;
-        // }
-
-        // // return processed samples from outputBuffer
-        // const int shiftStart = inputBlockLength;
-        // int shiftL = outputOffset + fftSize - hopSize - inputBlockLength;
-
-        // const int tooMuch = shiftStart + shiftL - outputBuffer.getNumSamples();
-        // if (tooMuch > 0)
-        //     shiftL -= tooMuch;
-
-        // for (int ch = 0; ch < numOutChannel; ++ch) {
-        //     FloatVectorOperations::copy (outputBlock.getChannelPointer (ch), outputBuffer.getReadPointer (ch), inputBlockLength);
-        //     FloatVectorOperations::copy (outputBuffer.getWritePointer (ch), outputBuffer.getReadPointer (ch, shiftStart), shiftL);
-        // }
-
-        // for (int ch = numChOut; ch < outputBlock.getNumChannels(); ++ch)
-        //     FloatVectorOperations::clear (outputBlock.getChannelPointer (ch), inputBlockLength);
-
-        // outputOffset += inputAudioBufferLenght;
+		for (int ch = numChOut; ch < outputBlock.getNumChannels(); ++ch)
+			FloatVectorOperations::clear(outputBlock.getChannelPointer(ch), inputBlockLength);
     }
 
-private:
-    virtual void createWindow()
+protected:
+    /**
+     Declares how the frames depend on each other, for offline rendering (see OfflineFrameRenderer). A processor
+     is FrameDependency::sequential until it declares otherwise, as the frame callbacks may keep any state; call
+     this from the constructor or prepare() of processors whose frames are independent or forget their past.
+     @param numFrames the number of frames of warm-up, only used with FrameDependency::warmUp
+     */
+    void setFrameDependency(const FrameDependency newFrameDependency, const int numFrames = 0)
     {
-        dsp::WindowingFunction<float>::fillWindowingTables(window.data(), fftSize, dsp::WindowingFunction<float>::WindowingMethod::hann, false);
+        frameDependency = newFrameDependency;
+        numWarmUpFrames = jmax(0, numFrames);
+    }
 
-        const float hopSizeCompensateFactor = 1.0f / (fftSize / hopSize / 2);
-        // for (auto& elem : window)
-            // elem *= hopSizeCompensateFactor;
+    // ====== the hooks of Derived. These are the defaults, a Derived member of the same name replaces them
+
+    /** Fills the analysis and synthesis window. Runs in prepare(), so after construction, when the hook of the
+        derived class can be reached, and never while processing */
+    void createWindow()
+    {
+        if (subFrameSize < fftSize)
+            window.createLowLatency(fftSize, hopSize, subFrameSize);
+        else
+            window.create(windowType, fftSize, hopSize, kaiserBeta);
     }
 
     /**
      This method get's called each time the processor has gathered enough samples for a transformation.
      The data in the `fftInOutBuffer` is still in time domain. Use the `fft` member to transform it into
      frequency domain, do your calculations, and transform it back to time domain.
+     With FftBufferLayout::channelInterleaved, the frames are in getInterleavedFrames() instead, and only those
+     get copied back afterwards.
+     By default, this hands the spectra of all channels to processSpectrum() if a SpectrumFormat is set,
+     and calls processChannelFrame() for every channel otherwise, with either layout.
      @param maxNumChannels the max number of channels of `fftInOutBuffer` you should use
      */
-    virtual void processFrameInBuffer(const int maxNumChannels) { }
+    void processFrameInBuffer(const int maxNumChannels)
+    {
+        if (spectrumFormat != SpectrumFormat::none) {
+            processSpectrumFrames(0, maxNumChannels);
+            return;
+        }
+
+        // processChannelFrame() works on `fftInOutBuffer`, which still holds the frames, so the untouched
+        // interleaved copies must not overwrite its results
+        if (fftBufferLayout == FftBufferLayout::channelInterleaved)
+            std::fill(frameChanged.get(), frameChanged.get() + maxNumChannels, (uint8)0);
+
+        for (int ch = 0; ch < maxNumChannels; ++ch)
+            derived().processChannelFrame(ch);
+    }
+
+    /**
+     Same as processFrameInBuffer(), but for a single channel of `fftInOutBuffer`. Override this one if the
+     channels are independent of each other; it's required for setParallelChannelProcessing(), where
+     it gets called for different channels on different threads at the same time.
+     By default, this hands the spectrum of the channel to processSpectrum() if a SpectrumFormat is set.
+     */
+    void processChannelFrame(const int ch)
+    {
+        if (spectrumFormat != SpectrumFormat::none)
+            processSpectrumFrames(ch, 1);
+    }
+
+    /**
+     Gets called with the spectra of a frame if a SpectrumFormat is set. The view holds all channels when called
+     from processFrameInBuffer(), and a single one when called from processChannelFrame(), i.e. with
+     setParallelChannelProcessing() or FrameScheduling::loadBalanced, where different channels are processed on
+     different threads at the same time.
+     */
+    void processSpectrum(SpectrumView& spectrum) { }
+
+private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+
+    /** Reads a run of output samples that doesn't cross the next hop, and starts a new frame at the hop */
+    void processOutputRun(dsp::AudioBlock<SampleType>& outputBlock, const int offset, const int numSamples, const int numChIn, const int numChOut)
+    {
+		// Get the output samples and clear their slots so they are ready for the next overlap-add.
+		// The overlap compensation is part of the synthesis window, so no scaling is needed
+		for (int ch = 0; ch < numChOut; ++ch)
+			gOutputBuffer.read(ch, outputBlock.getChannelPointer(ch) + offset, numSamples);
+
+		gOutputBuffer.advance(numSamples);
+
+		// Start a new FFT if we've reached the hop size
+		gHopCounter += numSamples;
+		if(gHopCounter >= hopSize) {
+			gHopCounter = 0;
+			processHop(numChIn, numChOut);
+		}
+		else if (frameScheduling == FrameScheduling::loadBalanced) {
+			// process the share of the pending channels that is due by now
+			const ProcessorTelemetry::ScopedFrames frameTiming(telemetry, 0);
+			processPendingChannels((pendingFrame.numChannels * gHopCounter + hopSize - 1) / hopSize);
+		}
+    }
+
+    /** Transforms the frames of a range of channels, calls processSpectrum() and transforms the modified ones back */
+    void processSpectrumFrames(const int firstChannel, const int numChannels)
+    {
+        SpectrumView view;
+        view.first = &spectrumFirst;
+        view.second = &spectrumSecond;
+        view.changed = frameChanged.get();
+        view.firstChannel = firstChannel;
+        view.numChannels = numChannels;
+        view.numBins = fftSize / 2 + 1;
+        view.format = spectrumFormat;
+
+        if (fftBufferLayout == FftBufferLayout::channelInterleaved) {
+            // a whole frame, transformed in groups of SIMD lanes. fftInOutBuffer keeps the time domain frames
+            // and only the modified channels get deinterleaved afterwards
+            jassert(firstChannel == 0);
+            for (int group = 0; group * lanes < numChannels; ++group) {
+                fft.performRealOnlyForwardTransformBatch(getInterleavedFrames(group), true);
+                for (int ch = group * lanes; ch < jmin(numChannels, (group + 1) * lanes); ++ch)
+                    unpackSpectrum(getInterleavedFrames(group) + ch % lanes, lanes, ch);
+            }
+
+            derived().processSpectrum(view);
+
+            for (int group = 0; group * lanes < numChannels; ++group) {
+                bool groupChanged = false;
+                for (int ch = group * lanes; ch < jmin(numChannels, (group + 1) * lanes); ++ch) {
+                    if (frameChanged[ch] != 0) {
+                        packSpectrum(getInterleavedFrames(group) + ch % lanes, lanes, ch);
+                        groupChanged = true;
+                    }
+                }
+
+                if (groupChanged)
+                    fft.performRealOnlyInverseTransformBatch(getInterleavedFrames(group));
+            }
+            return;
+        }
+
+        // transform a copy, so an unchanged channel still has its time domain frame in fftInOutBuffer
+        for (int ch = firstChannel; ch < firstChannel + numChannels; ++ch) {
+            FrameType* workspace = spectrumWorkspace.getWritePointer(ch);
+            FloatVectorOperations::copy(workspace, fftInOutBuffer.getReadPointer(ch), fftSize);
+            fft.performRealOnlyForwardTransform(workspace, true);
+            unpackSpectrum(workspace, 1, ch);
+        }
+
+        derived().processSpectrum(view);
+
+        for (int ch = firstChannel; ch < firstChannel + numChannels; ++ch) {
+            if (frameChanged[ch] != 0) {
+                packSpectrum(fftInOutBuffer.getWritePointer(ch), 1, ch);
+                fft.performRealOnlyInverseTransform(fftInOutBuffer.getWritePointer(ch));
+            }
+        }
+    }
+
+    /** Splits the packed bins of a channel (every stride-th value) into the split arrays of the spectrum view */
+    void unpackSpectrum(const FrameType* packed, const int stride, const int ch)
+    {
+        FrameType* first = spectrumFirst.getWritePointer(ch);
+        FrameType* second = spectrumSecond.getWritePointer(ch);
+        const int numBins = fftSize / 2 + 1;
+
+        for (int k = 0; k < numBins; ++k) {
+            first[k] = packed[2 * k * stride];
+            second[k] = packed[(2 * k + 1) * stride];
+        }
+
+        frameChanged[ch] = 1;
+
+        if (spectrumFormat == SpectrumFormat::polar) {
+            for (int k = 0; k < numBins; ++k) {
+                const FrameType re = first[k];
+                const FrameType im = second[k];
+                first[k] = std::sqrt(re * re + im * im);
+                second[k] = std::atan2(im, re);
+            }
+        }
+    }
+
+    /** Packs the split arrays of a channel back into the layout of the inverse transform */
+    void packSpectrum(FrameType* packed, const int stride, const int ch)
+    {
+        const FrameType* first = spectrumFirst.getReadPointer(ch);
+        const FrameType* second = spectrumSecond.getReadPointer(ch);
+        const int numBins = fftSize / 2 + 1;
+
+        if (spectrumFormat == SpectrumFormat::polar) {
+            for (int k = 0; k < numBins; ++k) {
+                packed[2 * k * stride] = first[k] * std::cos(second[k]);
+                packed[(2 * k + 1) * stride] = first[k] * std::sin(second[k]);
+            }
+        }
+        else {
+            for (int k = 0; k < numBins; ++k) {
+                packed[2 * k * stride] = first[k];
+                packed[(2 * k + 1) * stride] = second[k];
+            }
+        }
+    }
+
+    /**
+     Gathers the windowed frame of every input channel, lets processFrameInBuffer() work on all of them
+     in one call and overlap-adds the result of every output channel.
+     */
+    void processHop(const int numChIn, const int numChOut)
+    {
+		const int frameStart = gOutputBufferWritePointer - fftSize;
+
+		if (frameScheduling == FrameScheduling::workerThread) {
+			// hand the new frame over to the worker...
+			jassert(frameQueue.canSubmit());
+			auto& frame = frameQueue.getSubmitSlot();
+			gatherFrames(frame.buffer, numChIn, numChOut);
+			frame.frameStart = frameStart;
+			frame.numChIn = numChIn;
+			frame.numChOut = numChOut;
+			frameQueue.submit();
+			frameWorker->wakeup.signal();
+
+			// ...and collect the previous one, it is due now
+			if (frameQueue.getNumInFlight() > 1) {
+				// only happens if the worker takes longer than a hop (or doesn't get scheduled).
+				// Waiting for the worker is the frame time of the audio thread in this mode
+				{
+					const ProcessorTelemetry::ScopedFrames frameTiming(telemetry, 1);
+					while (! frameQueue.isOldestCompleted())
+						Thread::yield();
+				}
+
+				auto& previous = frameQueue.getOldest();
+				overlapAddFrames(previous.buffer, previous.frameStart, previous.numChOut);
+				frameQueue.release();
+			}
+		}
+		else if (frameScheduling == FrameScheduling::loadBalanced) {
+			// finish the frame gathered one hop ago and overlap-add it...
+			{
+				const ProcessorTelemetry::ScopedFrames frameTiming(telemetry, pendingFrame.numChannels > 0 ? 1 : 0);
+				processPendingChannels(pendingFrame.numChannels);
+			}
+			overlapAddFrames(fftInOutBuffer, pendingFrame.frameStart, pendingFrame.numChOut);
+
+			// ...then gather the new one, its channels get processed during the next hop
+			gatherFrames(fftInOutBuffer, numChIn, numChOut);
+			pendingFrame.frameStart = frameStart;
+			pendingFrame.numChOut = numChOut;
+			pendingFrame.numChannels = jmax(numChIn, numChOut);
+			pendingFrame.numChannelsDone = 0;
+		}
+		else {
+			gatherFrames(fftInOutBuffer, numChIn, numChOut);
+			{
+				const ProcessorTelemetry::ScopedFrames frameTiming(telemetry, 1);
+				processFrames(jmax(numChIn, numChOut));
+			}
+			overlapAddFrames(fftInOutBuffer, frameStart, numChOut);
+		}
+
+		gOutputBufferWritePointer = gOutputBuffer.wrap(gOutputBufferWritePointer + hopSize);
+    }
+
+    /** Runs the frame callback, spread over the channel threads if there are enough channels */
+    void processFrames(const int maxNumChannels)
+    {
+        if (fftBufferLayout == FftBufferLayout::channelInterleaved) {
+            std::fill(frameChanged.get(), frameChanged.get() + maxNumChannels, (uint8)1);
+            interleaveFrames(maxNumChannels);
+            derived().processFrameInBuffer(maxNumChannels);
+            deinterleaveFrames(maxNumChannels);
+        }
+        else if (channelThreads.getNumThreads() > 1 && maxNumChannels >= minNumChannelsForThreads)
+            processChannelRange(0, maxNumChannels);
+        else
+            derived().processFrameInBuffer(maxNumChannels);
+    }
+
+    /** Copies the frames of `fftInOutBuffer` into the channel-interleaved groups, unused lanes are silent */
+    void interleaveFrames(const int maxNumChannels)
+    {
+        const int numGroups = (maxNumChannels + lanes - 1) / lanes;
+
+        for (int group = 0; group < numGroups; ++group) {
+            FrameType* interleaved = getInterleavedFrames(group);
+
+            for (int lane = 0; lane < lanes; ++lane) {
+                const int ch = group * lanes + lane;
+
+                if (ch < maxNumChannels) {
+                    const FrameType* frame = fftInOutBuffer.getReadPointer(ch);
+                    for (int n = 0; n < fftSize; ++n)
+                        interleaved[n * lanes + lane] = frame[n];
+                }
+                else {
+                    for (int n = 0; n < fftSize; ++n)
+                        interleaved[n * lanes + lane] = FrameType();
+                }
+            }
+        }
+    }
+
+    /** Copies the processed frames back from the channel-interleaved groups into `fftInOutBuffer` */
+    void deinterleaveFrames(const int maxNumChannels)
+    {
+        for (int ch = 0; ch < maxNumChannels; ++ch) {
+            // an unchanged spectrum leaves the frame as it was
+            if (frameChanged[ch] == 0)
+                continue;
+
+            const FrameType* interleaved = getInterleavedFrames(ch / lanes) + ch % lanes;
+            FrameType* frame = fftInOutBuffer.getWritePointer(ch);
+
+            for (int n = 0; n < fftSize; ++n)
+                frame[n] = interleaved[n * lanes];
+        }
+    }
+
+    /** Calls processChannelFrame() for numChannels channels, spread over the channel threads if there are enough */
+    void processChannelRange(const int firstChannel, const int numChannels)
+    {
+        if (channelThreads.getNumThreads() > 1 && numChannels >= minNumChannelsForThreads) {
+            auto processChannel = [this, firstChannel](const int i) { derived().processChannelFrame(firstChannel + i); };
+            channelThreads.run(numChannels, processChannel);
+        }
+        else {
+            for (int ch = firstChannel; ch < firstChannel + numChannels; ++ch)
+                derived().processChannelFrame(ch);
+        }
+    }
 
-    void writeBackFrame()
+    /** Processes the channels of the pending frame (loadBalanced scheduling) up to, but excluding, channel endChannel */
+    void processPendingChannels(const int endChannel)
     {
-        for (int ch = 0; ch < numOutChannel; ++ch) {
-            outputBuffer.addFrom(ch, outputOffset, fftInOutBuffer, ch, 0, fftSize - hopSize);
-            outputBuffer.copyFrom(ch, outputOffset + fftSize - hopSize, fftInOutBuffer, ch, fftSize - hopSize, hopSize);
+        if (endChannel > pendingFrame.numChannelsDone) {
+            processChannelRange(pendingFrame.numChannelsDone, endChannel - pendingFrame.numChannelsDone);
+            pendingFrame.numChannelsDone = endChannel;
         }
-        outputOffset += hopSize;
     }
 
+    /** Copies the latest frame of every channel into frames, applying the analysis window */
+    void gatherFrames(AudioBuffer<FrameType>& frames, const int numChIn, const int numChOut)
+    {
+		for (int ch = 0; ch < numChIn; ++ch)
+			window.applyAnalysis(frames.getWritePointer(ch), inputRing->getLatestSamples(ch, fftSize), 0, fftSize);
+
+		// output channels without an input get a silent frame
+		for (int ch = numChIn; ch < numChOut; ++ch)
+			FloatVectorOperations::clear(frames.getWritePointer(ch), fftSize);
+    }
+
+    /** Overlap-adds the frame of every output channel, applying the synthesis window, which is zero in front of the sub-frame */
+    void overlapAddFrames(const AudioBuffer<FrameType>& frames, const int frameStart, const int numChOut)
+    {
+		const int offset = fftSize - subFrameSize;
+		for (int ch = 0; ch < numChOut; ++ch)
+			window.addSynthesised(gOutputBuffer.getFrameWritePointer(ch, frameStart + offset), frames.getReadPointer(ch) + offset, offset, subFrameSize);
+    }
+
+    /** Runs on the worker thread, which owns `fftInOutBuffer` in this mode */
+    void processQueuedFrame(typename FrameQueue<FrameType>::Frame& frame)
+    {
+        const auto maxNumChannels = jmax(frame.numChIn, frame.numChOut);
+
+        for (int ch = 0; ch < maxNumChannels; ++ch)
+            fftInOutBuffer.copyFrom(ch, 0, frame.buffer, ch, 0, fftSize);
+
+        processFrames(maxNumChannels);
+
+        for (int ch = 0; ch < frame.numChOut; ++ch)
+            frame.buffer.copyFrom(ch, 0, fftInOutBuffer, ch, 0, fftSize);
+    }
+
+protected:
+    /**
+     Stops the worker thread of FrameScheduling::workerThread. Call this first thing in the destructor of the most
+     derived class: the worker calls the frame callbacks of Derived, which must not run on a partly destroyed object.
+     */
+    void stopFrameWorker()
+    {
+        // wakes the worker, which otherwise sleeps until the next frame
+        if (frameWorker != nullptr)
+            frameWorker->wakeup.stopWorker(*frameWorker);
+
+        frameWorker.reset();
+    }
+
+private:
+    class FrameWorker : public Thread {
+    public:
+        FrameWorker(OverlapAddFftProcessorBase& processor)
+            : Thread("OverlapAddFftProcessor frame worker")
+            , owner(processor)
+        {
+        }
+
+        void run() override
+        {
+            while (wakeup.waitForSignal(*this)) {
+                while (auto* frame = owner.frameQueue.getNextPending()) {
+                    owner.processQueuedFrame(*frame);
+                    owner.frameQueue.markCompleted();
+                }
+            }
+        }
+
+        /** Signalled by the audio thread for every submitted frame, the worker sleeps on it in between */
+        WorkerWakeup wakeup;
+
+    private:
+        OverlapAddFftProcessorBase& owner;
+    };
+
 protected:
-    dsp::FFT fft;
+    FftBackend<FrameType> fft;
     const int fftSize;
     const int hopSize;
-	float gScaleFactor = 0.5;
-    const int gBufferSize = 16384;
 
-    std::vector<float> window;
-    // std::vector<float> gInputBuffer;
-    // std::vector<float> gOutputBuffer;
-    AudioBuffer<float> fftInOutBuffer;
-    double sampleRate;
+    FftWindowType windowType;
+    float kaiserBeta = 8.0f;
+    int subFrameSize = 0;
+    FftWindow<FrameType> window;
+    AudioBuffer<FrameType> fftInOutBuffer;
+    double sampleRate = 44100.0;
+
+    /**
+     With FftBufferLayout::channelInterleaved, returns the frames of channels group * lanes and up:
+     index i of the single-channel layout (sample, or real/imaginary part of a bin) of the channel in lane l is at
+     [i * lanes + l]. Each group holds 2 * fftSize * lanes values and is SIMD aligned.
+     */
+    FrameType* getInterleavedFrames(const int group) noexcept
+    {
+        jassert(group < numInterleavedGroups);
+        return interleavedFftBuffer.get() + group * 2 * fftSize * lanes;
+    }
 
-    // AudioBuffer<float> notYetUsedAudioData;
+    /** The number of channels per group of the channel-interleaved layout */
+    static constexpr int lanes = FftBackend<FrameType>::batchSize;
 
 private:
     int numInpChannel;
     int numOutChannel;
 
-    AudioBuffer<float> gInputBuffer;
-    int gInputBufferPointer = 0;
+    MirroredRingBuffer<SampleType> gInputBuffer;
+    const MirroredRingBuffer<SampleType>* sharedInput = nullptr;
+    const MirroredRingBuffer<SampleType>* inputRing = &gInputBuffer;
 	int gHopCounter = 0;
 
-    AudioBuffer<float> gOutputBuffer;
+    MirroredOverlapAddBuffer<SampleType> gOutputBuffer;
 	int gOutputBufferWritePointer = 0;
-	int gOutputBufferReadPointer = 0;
-	int gCachedInputBufferPointer = 0;
+	int latencySamples = 0;
+	int additionalLatency = 0;
+
+    FrameDependency frameDependency = FrameDependency::sequential;
+    int numWarmUpFrames = 0;
+
+    ProcessorTelemetry* telemetry = nullptr;
+
+    // the subFrameSize of the next call of prepare()
+    int requestedSubFrameSize = 0;
+
+    FrameScheduling frameScheduling = FrameScheduling::audioThread;
+    FrameQueue<FrameType> frameQueue;
+    std::unique_ptr<FrameWorker> frameWorker;
+
+    /** The frame waiting in `fftInOutBuffer` with loadBalanced scheduling */
+    struct PendingFrame {
+        int frameStart = 0;
+        int numChOut = 0;
+        int numChannels = 0;
+        int numChannelsDone = 0;
+    };
+    PendingFrame pendingFrame;
+
+    FftBufferLayout fftBufferLayout = FftBufferLayout::perChannel;
+    AlignedArray<FrameType> interleavedFftBuffer;
+    int numInterleavedGroups = 0;
 
-    int inpBufferWritePointer = 0;
-    int inpBufferReadPointer = 0;
-    int inputAudioBufferLenght = 0;
-    int notYetUsedAudioDataCount = 0;
+    SpectrumFormat spectrumFormat = SpectrumFormat::none;
+    AudioBuffer<FrameType> spectrumWorkspace;
+    AudioBuffer<FrameType> spectrumFirst;
+    AudioBuffer<FrameType> spectrumSecond;
+    HeapBlock<uint8> frameChanged;
 
-    AudioBuffer<float> outputBuffer;
-    int outputOffset = fftSize;
+    int numChannelThreads = 1;
+    int minNumChannelsForThreads = 8;
+    ChannelThreadPool channelThreads;
 
-    JUCE_DECLARE_NON_COPYABLE(OverlapAddFftProcessor)
-};
\ No newline at end of file
+    JUCE_DECLARE_NON_COPYABLE(OverlapAddFftProcessorBase)
+};
+
+/**
+ OverlapAddFftProcessorBase with virtual frame callbacks, for processors that override them in a subclass
+ or are used through a base class pointer. Costs one virtual call per frame (or per channel of a frame).
+ */
+template <typename Sample, typename Frame = Sample>
+class BasicOverlapAddFftProcessor : public OverlapAddFftProcessorBase<BasicOverlapAddFftProcessor<Sample, Frame>, Sample, Frame> {
+    using Base = OverlapAddFftProcessorBase<BasicOverlapAddFftProcessor<Sample, Frame>, Sample, Frame>;
+    friend Base;
+
+public:
+    using typename Base::SpectrumView;
+
+    BasicOverlapAddFftProcessor(const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1, const FftWindowType windowType = FftWindowType::hann,
+                                const FftBackendType fftBackendType = (FftBackendType)OVERLAP_ADD_FFT_BACKEND)
+        : Base(fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2, windowType, fftBackendType)
+    {
+    }
+
+    virtual ~BasicOverlapAddFftProcessor()
+    {
+        // a subclass with own state has to do this in its destructor already
+        this->stopFrameWorker();
+    }
+
+protected:
+    // see OverlapAddFftProcessorBase for what they do by default
+    virtual void createWindow() { Base::createWindow(); }
+    virtual void processFrameInBuffer(const int maxNumChannels) { Base::processFrameInBuffer(maxNumChannels); }
+    virtual void processChannelFrame(const int ch) { Base::processChannelFrame(ch); }
+    virtual void processSpectrum(SpectrumView& spectrum) { Base::processSpectrum(spectrum); }
+};
+
+using OverlapAddFftProcessor = BasicOverlapAddFftProcessor<float>;
+using DoubleOverlapAddFftProcessor = BasicOverlapAddFftProcessor<double>;
+using MixedOverlapAddFftProcessor = BasicOverlapAddFftProcessor<double, float>;
\ No newline at end of file
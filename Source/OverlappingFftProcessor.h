@@ -33,6 +33,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FftWindow.h"
+#include "MirroredRingBuffer.h"
+#include "ChannelThreadPool.h"
+#include "FftBackend.h"
 
 using namespace juce;
 
@@ -40,16 +44,22 @@ using namespace juce;
  This processor takes care of buffering input and output samples for your FFT processing.
  With fttSizeAsPowerOf2 and hopSizeDividerAsPowerOf2 the fftSize and hopSize can be specifiec.
  Inherit from this class and override the processFrameInBuffer() function in order to
- implement your processing. You can also override the `createWindow()` method to use
- another window (default: Hann window).
+ implement your processing, or processChannelFrame() if every channel is processed on its own. Pass a FftWindowType to the constructor or call setWindowType()
+ to use another window (default: Hann window).
+ SampleType is the type of the audio and of the overlap-add, FrameType the one of the frames and the transforms,
+ see BasicOverlapAddFftProcessor.
+ The hooks are resolved statically, as in OverlapAddFftProcessorBase: Derived implements them and has to declare
+ them public or befriend this class. OverlappingFFTProcessor and its siblings are Derived for processors that
+ override them as virtual functions instead.
  @code
- class MyProcessor : public OverlappingFFTProcessor
+ class MyProcessor final : public OverlappingFFTProcessorBase<MyProcessor, float>
  {
  public:
-     MyProcessor () : OverlappingFFTProcessor (11, 2) {}
-     ~MyProcessor() {}
+     MyProcessor () : OverlappingFFTProcessorBase (11, 2) {}
  private:
-     void processFrameInBuffer (const int maxNumChannels) override
+     friend OverlappingFFTProcessorBase;
+
+     void processFrameInBuffer (const int maxNumChannels)
      {
          for (int ch = 0; ch < maxNumChannels; ++ch)
             fft.performRealOnlyForwardTransform (fftInOutBuffer.getWritePointer (ch), true);
@@ -62,15 +72,22 @@ using namespace juce;
  };
  */
 
-class OverlappingFFTProcessor
+template <typename Derived, typename Sample, typename Frame = Sample>
+class OverlappingFFTProcessorBase
 {
 public:
+    using SampleType = Sample;
+    using FrameType = Frame;
+
     /** Constructor
      @param fftSizeAsPowerOf2 defines the fftSize as a power of 2: fftSize = 2^fftSizeAsPowerOf2
      @param hopSizeDividerAsPowerOf2 defines the hopSize as a fraction of fftSize: hopSize = fftSize / (2^hopSizeDivider)
+     @param windowType the window used for analysis and synthesis
+     @param fftBackendType the FFT engine behind `fft`, by default the one set with OVERLAP_ADD_FFT_BACKEND
      */
-    OverlappingFFTProcessor (const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1)
-    : fft (fftSizeAsPowerOf2), fftSize (1 << fftSizeAsPowerOf2), hopSize (fftSize >> hopSizeDividerAsPowerOf2)
+    OverlappingFFTProcessorBase (const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1, const FftWindowType windowType = FftWindowType::hann,
+                                 const FftBackendType fftBackendType = (FftBackendType) OVERLAP_ADD_FFT_BACKEND)
+    : fft (fftSizeAsPowerOf2, fftBackendType), fftSize (1 << fftSizeAsPowerOf2), hopSize (fftSize >> hopSizeDividerAsPowerOf2), windowType (windowType)
     {
         // make sure you have at least an overlap of 50%
         jassert (hopSizeDividerAsPowerOf2 > 0);
@@ -80,177 +97,157 @@ public:
 
         DBG ("Overlapping FFT Processor created with fftSize: " << fftSize << " and hopSize: " << hopSize);
 
-        // create window
-        window.resize (fftSize);
-        createWindow();
+        // the window is created in prepare(), Derived isn't constructed yet here
+    }
 
-        // don`t change the size of the window during createWindow()!
-        jassert (window.size() == fftSize);
+
+    /** Clears all buffered audio, as after prepare(). Doesn't allocate, so it can be called from the audio thread. */
+    void reset()
+    {
+        inputHistory.clear();
+        outputBuffer.clear();
+        outputWritePosition = fftSize - 1;
+        samplesToNextFrame = fftSize;
     }
-    
-    virtual ~OverlappingFFTProcessor() {}
 
+    /** Returns the delay in samples between input and output */
+    int getLatencySamples() const { return fftSize - 1; }
+
+    /** Changes the analysis and synthesis window, takes effect with the next call of prepare(), which rebuilds
+        the window while nothing reads it.
+     @param kaiserBeta shape parameter, only used for FftWindowType::kaiser
+     */
+    void setWindowType (const FftWindowType newWindowType, const float newKaiserBeta = 8.0f)
+    {
+        windowType = newWindowType;
+        kaiserBeta = newKaiserBeta;
+    }
 
-    void reset() {}
+    /**
+     Spreads the channels of each frame over a pool of threads, takes effect with the next call of prepare().
+     This calls processChannelFrame() for every channel instead of processFrameInBuffer(), so only use it
+     with processors that override processChannelFrame().
+     @param numThreads the number of threads including the one calling process(), 1 turns it off
+     @param minNumChannels frames with fewer channels are processed serially, as waking the pool wouldn't pay off
+     */
+    void setParallelChannelProcessing (const int numThreads, const int minNumChannels = 8)
+    {
+        numChannelThreads = numThreads;
+        minNumChannelsForThreads = minNumChannels;
+    }
 
     void prepare (const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
     {
+        channelThreads.start (numChannelThreads);
+        derived().createWindow();
+
 		this->sampleRate = sampleRate;
         nChIn = numInputChannels;
         nChOut = numOutputChannels;
         const auto maxCh = jmax (nChIn, nChOut);
 
-        const int bufferSize = maximumBlockSize;
-
-        notYetUsedAudioData.setSize (nChIn, fftSize - 1);
         fftInOutBuffer.setSize (maxCh, 2 * fftSize);
 
-        const int k = floor (1.0f + ((float) (bufferSize - 1)) / hopSize);
-        const int M = k * hopSize + (fftSize - hopSize);
-
-        outputBuffer.setSize (nChIn, M + bufferSize - 1); // not sure if (bufferSize - 1) could be too much, but it's working like a charm... so.. whatever...
-        outputBuffer.clear();
-
-        int offset = 0;
-        while (offset < fftSize)
-            offset += bufferSize;
-
-        outputOffset = offset - bufferSize;
+        // the samples before the current block, for frames that start in an earlier one
+        inputHistory.setSize (nChIn, fftSize);
 
-        outputOffset = fftSize - 1;
+        // a frame ending at sample e of a block is added from e - 1 on, so the output has to reach
+        // from the read position up to a block and a frame ahead
+        maxBlockSize = maximumBlockSize;
+        outputBuffer.setSize (nChOut, maximumBlockSize + fftSize);
 
-        notYetUsedAudioDataCount = 0;
+        reset();
     }
 
 
-    void process (const dsp::ProcessContextReplacing<float>& context)
+    void process (const dsp::ProcessContextReplacing<SampleType>& context)
     {
         process (context.getInputBlock(), context.getOutputBlock());
     }
 
-    void process (const dsp::ProcessContextNonReplacing<float>& context)
+    void process (const dsp::ProcessContextNonReplacing<SampleType>& context)
     {
         process (context.getInputBlock(), context.getOutputBlock());
     }
 
-    void process (const dsp::AudioBlock<const float>& inputBlock, dsp::AudioBlock<float>& outputBlock)
+    void process (const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
     {
+        // the output ring only holds the frames of blocks up to the size given to prepare()
+        if ((int) inputBlock.getNumSamples() > maxBlockSize)
+        {
+            for (size_t start = 0; start < inputBlock.getNumSamples(); start += (size_t) maxBlockSize)
+            {
+                const auto length = jmin ((size_t) maxBlockSize, inputBlock.getNumSamples() - start);
+                auto outputRun = outputBlock.getSubBlock (start, length);
+                process (inputBlock.getSubBlock (start, length), outputRun);
+            }
+            return;
+        }
+
         const auto L = (int) inputBlock.getNumSamples();
         const auto numChIn = jmin (static_cast<int> (inputBlock.getNumChannels()), nChIn);
         const auto numChOut = jmin (static_cast<int> (outputBlock.getNumChannels()), nChOut);
         const auto maxNumChannels = jmax (numChIn, numChOut);
 
-        const int initialNotYetUsedAudioDataCount = notYetUsedAudioDataCount;
-        int notYetUsedAudioDataOffset = 0;
-        int usedSamples = 0;
-
-
-        // we've got some left overs, so let's use them together with the new samples
-        while (notYetUsedAudioDataCount > 0 && notYetUsedAudioDataCount + L >= fftSize)
+        // frames end every hop, the first one once fftSize samples have come in. A frame that lies within the
+        // block is windowed straight from the host's memory, only one that starts in an earlier block takes its
+        // first part from the input history. With blocks of a multiple of the hop, at least fftSize long,
+        // every frame but the first (fftSize - hopSize) / hopSize of a block takes the direct path.
+        for (int frameEnd = samplesToNextFrame; frameEnd <= L; frameEnd += hopSize)
         {
-            // copy not yet used data into fftInOut buffer (with hann windowing)
-            for (int ch = 0; ch < numChIn; ++ch)
-            {
-                FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch), // destination
-                                                 notYetUsedAudioData.getReadPointer (ch, notYetUsedAudioDataOffset), // source 1 (audio data)
-                                                 window.data(), // source 2 (window)
-                                                 notYetUsedAudioDataCount // number of samples
-                                                );
-
-                // fill up fftInOut buffer with new data (with hann windowing)
-                FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch, notYetUsedAudioDataCount), // destination
-                                                 inputBlock.getChannelPointer (ch), // source 1 (audio data)
-                                                 window.data() + notYetUsedAudioDataCount, // source 2 (window)
-                                                 fftSize - notYetUsedAudioDataCount // number of samples
-                                                );
-            }
+            const int numHistorySamples = jmax (0, fftSize - frameEnd);
 
-            // process frame and buffer output
-            processFrameInBuffer (maxNumChannels);
-            writeBackFrame();
-
-            notYetUsedAudioDataOffset += hopSize;
-            notYetUsedAudioDataCount -= hopSize;
-        }
-        
-        if (notYetUsedAudioDataCount > 0) // not enough new input samples to use all of the previous data
-        {
             for (int ch = 0; ch < numChIn; ++ch)
             {
-                FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch),		//destination
-                                             notYetUsedAudioData.getReadPointer (ch, initialNotYetUsedAudioDataCount - notYetUsedAudioDataCount),	// source
-                                             notYetUsedAudioDataCount);		// number of samples
-                FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch, notYetUsedAudioDataCount),	//destination
-                                             inputBlock.getChannelPointer (ch) + usedSamples,	// source
-                                             L);		// number of samples
-            }
-            notYetUsedAudioDataCount += L;
-        }
-        else  // all of the previous data used
-        {
-            int dataOffset = - notYetUsedAudioDataCount;
-            
-            while (L - dataOffset >= fftSize)
-            {
-                for (int ch = 0; ch < numChIn; ++ch)
+                if (numHistorySamples == 0)
                 {
-                    FloatVectorOperations::multiply (fftInOutBuffer.getWritePointer (ch),	// dest
-                                                     inputBlock.getChannelPointer (ch) + dataOffset,	// src1
-                                                     window.data(),		// src2 
-													 fftSize);		// number of samples
+                    window.applyAnalysis (fftInOutBuffer.getWritePointer (ch), inputBlock.getChannelPointer (ch) + frameEnd - fftSize, 0, fftSize);
                 }
-                processFrameInBuffer (maxNumChannels);
-                writeBackFrame();
-
-                dataOffset += hopSize;
-            }
-            
-            int remainingSamples = L - dataOffset;
-            if (remainingSamples > 0)
-            {
-                for (int ch = 0; ch < numChIn; ++ch)
+                else
                 {
-                    FloatVectorOperations::copy (notYetUsedAudioData.getWritePointer (ch),
-                                                 inputBlock.getChannelPointer (ch) + dataOffset,
-                                                 L - dataOffset);
+                    window.applyAnalysis (fftInOutBuffer.getWritePointer (ch), inputHistory.getLatestSamples (ch, numHistorySamples), 0, numHistorySamples);
+                    window.applyAnalysis (fftInOutBuffer.getWritePointer (ch, numHistorySamples), inputBlock.getChannelPointer (ch),
+                                          numHistorySamples, frameEnd);
                 }
             }
-            notYetUsedAudioDataCount = remainingSamples;
-        }
 
+            // output channels without an input get a silent frame
+            for (int ch = numChIn; ch < numChOut; ++ch)
+                FloatVectorOperations::clear (fftInOutBuffer.getWritePointer (ch), fftSize);
 
-        // return processed samples from outputBuffer
-        const int shiftStart = L;
-        int shiftL = outputOffset + fftSize - hopSize - L;
+            // process frame and buffer output
+            processFrames (maxNumChannels);
+            writeBackFrame (numChOut);
+
+            samplesToNextFrame = frameEnd + hopSize;
+        }
+        samplesToNextFrame -= L;
 
-        const int tooMuch = shiftStart + shiftL - outputBuffer.getNumSamples();
-        if (tooMuch > 0)
-            shiftL -= tooMuch;
+        // keep the end of the block for frames reaching into the next ones. This has to happen before reading
+        // the output, as input and output may share memory (replacing context)
+        const int numNewHistorySamples = jmin (L, inputHistory.getCapacity());
+        for (int ch = 0; ch < numChIn; ++ch)
+            inputHistory.write (ch, inputBlock.getChannelPointer (ch) + L - numNewHistorySamples, numNewHistorySamples);
+        inputHistory.advance (numNewHistorySamples);
 
+        // return processed samples from the output ring, which clears them for the next overlap-add
         for (int ch = 0; ch < numChOut; ++ch)
-        {
-            FloatVectorOperations::copy (outputBlock.getChannelPointer (ch), outputBuffer.getReadPointer (ch), L);
-            FloatVectorOperations::copy (outputBuffer.getWritePointer (ch), outputBuffer.getReadPointer (ch, shiftStart), shiftL);
-        }
+            outputBuffer.read (ch, outputBlock.getChannelPointer (ch), L);
+        outputBuffer.advance (L);
 
         for (int ch = numChOut; ch < outputBlock.getNumChannels(); ++ch)
             FloatVectorOperations::clear (outputBlock.getChannelPointer (ch), L);
-
-        outputOffset -= L;
     }
 
     const int getNumInputChannels() const { return nChIn; }
     const int getNumOutputChannels() const { return nChOut; }
-    
-private:
-    virtual void createWindow()
-    {
-        dsp::WindowingFunction<float>::fillWindowingTables (window.data(), fftSize, dsp::WindowingFunction<float>::WindowingMethod::hann, false);
 
-        const float hopSizeCompensateFactor = 1.0f / (fftSize / hopSize / 2);	//1024 / 256 = 4 / 2 = 2 -> 1 / 2 = 0.5
-        // const float hopSizeCompensateFactor = hopSize * 2 / fftSize;		
-        // for (auto& elem : window)
-        //     elem *= hopSizeCompensateFactor;
+protected:
+    // ====== the hooks of Derived. These are the defaults, a Derived member of the same name replaces them
+
+    void createWindow()
+    {
+        window.create (windowType, fftSize, hopSize, kaiserBeta);
     }
 
     /**
@@ -259,40 +256,101 @@ private:
      frequency domain, do your calculations, and transform it back to time domain.
      @param maxNumChannels the max number of channels of `fftInOutBuffer` you should use
      */
-    virtual void processFrameInBuffer (const int maxNumChannels) {}
+    void processFrameInBuffer (const int maxNumChannels)
+    {
+        for (int ch = 0; ch < maxNumChannels; ++ch)
+            derived().processChannelFrame (ch);
+    }
+
+    /**
+     Same as processFrameInBuffer(), but for a single channel of `fftInOutBuffer`. Override this one if the
+     channels are independent of each other; it's required for setParallelChannelProcessing(), where
+     it gets called for different channels on different threads at the same time.
+     */
+    void processChannelFrame (const int ch) {}
+
+private:
+    Derived& derived() noexcept { return static_cast<Derived&> (*this); }
 
-    void writeBackFrame()
+    /** Runs the frame callback, spread over the channel threads if there are enough channels */
+    void processFrames (const int maxNumChannels)
     {
-        for (int ch = 0; ch < nChOut; ++ch)
+        if (channelThreads.getNumThreads() > 1 && maxNumChannels >= minNumChannelsForThreads)
         {
-			// FloatVectorOperations::multiply(fftInOutBuffer.getWritePointer (ch),	// dest
-			// 								fftInOutBuffer.getReadPointer(ch),	// src1
-			// 								window.data(),		// src2 
-			// 								fftSize);		// number of samples
-            outputBuffer.addFrom (ch, outputOffset, fftInOutBuffer, ch, 0, fftSize - hopSize);
-            outputBuffer.copyFrom (ch, outputOffset + fftSize - hopSize, fftInOutBuffer, ch, fftSize - hopSize, hopSize);
-
+            auto processChannel = [this] (const int ch) { derived().processChannelFrame (ch); };
+            channelThreads.run (maxNumChannels, processChannel);
+        }
+        else
+        {
+            derived().processFrameInBuffer (maxNumChannels);
         }
-        outputOffset += hopSize;
+    }
+
+    void writeBackFrame (const int numChOut)
+    {
+        // slots are cleared when they are read, so the whole frame is added (with synthesis windowing)
+        for (int ch = 0; ch < numChOut; ++ch)
+            window.addSynthesised (outputBuffer.getFrameWritePointer (ch, outputWritePosition),	// dest
+                                   fftInOutBuffer.getReadPointer (ch),	// frame
+                                   0,		// window offset
+                                   fftSize);		// number of samples
+
+        outputWritePosition = outputBuffer.wrap (outputWritePosition + hopSize);
     }
 
 protected:
-    dsp::FFT fft;
-    std::vector<float> window;
-    AudioBuffer<float> fftInOutBuffer;
+    FftBackend<FrameType> fft;
+    AudioBuffer<FrameType> fftInOutBuffer;
     const int fftSize;
     const int hopSize;
+    FftWindowType windowType;
+    float kaiserBeta = 8.0f;
+    FftWindow<FrameType> window;
 	double sampleRate;
 
 private:
     int nChIn;
     int nChOut;
 
-    AudioBuffer<float> notYetUsedAudioData;
-    AudioBuffer<float> outputBuffer;
-    int outputOffset;
+    MirroredRingBuffer<SampleType> inputHistory;
+    MirroredOverlapAddBuffer<SampleType> outputBuffer;
+    int outputWritePosition = 0;
+    int samplesToNextFrame = 0;
+    int maxBlockSize = 0;
 
-    int notYetUsedAudioDataCount = 0;
+    int numChannelThreads = 1;
+    int minNumChannelsForThreads = 8;
+    ChannelThreadPool channelThreads;
 
-    JUCE_DECLARE_NON_COPYABLE (OverlappingFFTProcessor)
-};
\ No newline at end of file
+    JUCE_DECLARE_NON_COPYABLE (OverlappingFFTProcessorBase)
+};
+
+/**
+ OverlappingFFTProcessorBase with virtual hooks, for processors that override them in a subclass.
+ Costs one virtual call per frame (or per channel of a frame).
+ */
+template <typename Sample, typename Frame = Sample>
+class BasicOverlappingFFTProcessor : public OverlappingFFTProcessorBase<BasicOverlappingFFTProcessor<Sample, Frame>, Sample, Frame>
+{
+    using Base = OverlappingFFTProcessorBase<BasicOverlappingFFTProcessor<Sample, Frame>, Sample, Frame>;
+    friend Base;
+
+public:
+    BasicOverlappingFFTProcessor (const int fftSizeAsPowerOf2, const int hopSizeDividerAsPowerOf2 = 1, const FftWindowType windowType = FftWindowType::hann,
+                                  const FftBackendType fftBackendType = (FftBackendType) OVERLAP_ADD_FFT_BACKEND)
+    : Base (fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2, windowType, fftBackendType)
+    {
+    }
+
+    virtual ~BasicOverlappingFFTProcessor() {}
+
+private:
+    // see OverlappingFFTProcessorBase for what they do by default
+    virtual void createWindow() { Base::createWindow(); }
+    virtual void processFrameInBuffer (const int maxNumChannels) { Base::processFrameInBuffer (maxNumChannels); }
+    virtual void processChannelFrame (const int ch) { Base::processChannelFrame (ch); }
+};
+
+using OverlappingFFTProcessor = BasicOverlappingFFTProcessor<float>;
+using DoubleOverlappingFFTProcessor = BasicOverlappingFFTProcessor<double>;
+using MixedOverlappingFFTProcessor = BasicOverlappingFFTProcessor<double, float>;
\ No newline at end of file
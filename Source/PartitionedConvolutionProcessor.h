@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolutionProcessor.h
+    Created: 19 Oct 2026 10:26:00am
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OverlapAddFftProcessor.h"
+
+using namespace juce;
+
+/**
+ Convolves with (a segment of) an impulse response by uniformly partitioned overlap-save: the response is cut into
+ partitions of partitionSize samples and every frame of 2 * partitionSize input samples is transformed once into
+ a frequency-domain delay line. Each hop, the spectra of the last numPartitions frames are multiplied with the
+ partition spectra and summed, and a single inverse transform gives the next partitionSize output samples.
+ The latency is one partition (plus one hop with FrameScheduling::workerThread).
+
+ The buffering is the one of OverlapAddFftProcessor, with an overlap-save window pair instead of the analysis and
+ synthesis windows, so don't call setWindowType() or setSubFrameSize() on it.
+ */
+class UniformPartitionedConvolver final : public OverlapAddFftProcessorBase<UniformPartitionedConvolver, float> {
+    using Base = OverlapAddFftProcessorBase<UniformPartitionedConvolver, float>;
+    friend Base;
+
+public:
+    /**
+     @param partitionSizeAsPowerOf2 the size of the partitions and the hop, the transforms are twice as long
+     @param impulseResponse the response, one channel per output channel or one for all of them
+     @param startSample the first sample of the response handled by this convolver
+     @param numPartitions the number of partitions from startSample on, 0 for the whole rest of the response
+     */
+    UniformPartitionedConvolver(const int partitionSizeAsPowerOf2, const AudioBuffer<float>& impulseResponse, const int startSample = 0, const int numPartitions = 0)
+        : Base(partitionSizeAsPowerOf2 + 1, 1)
+        , numBins(roundUp(hopSize + 1, SimdRealFft<float>::batchSize))
+    {
+        const int numSamples = impulseResponse.getNumSamples() - startSample;
+        partitionCount = numPartitions > 0 ? numPartitions : jmax(1, (numSamples + hopSize - 1) / hopSize);
+        numIrChannels = jmax(1, impulseResponse.getNumChannels());
+
+        // the partition spectra, split into real and imaginary parts for the multiply-accumulate
+        partitionSpectra.allocate(numIrChannels * partitionCount * 2 * numBins, true);
+
+        HeapBlock<float> frame((size_t)(2 * fftSize));
+        for (int ch = 0; ch < impulseResponse.getNumChannels(); ++ch) {
+            for (int p = 0; p < partitionCount; ++p) {
+                const int start = startSample + p * hopSize;
+                const int length = jlimit(0, hopSize, impulseResponse.getNumSamples() - start);
+
+                FloatVectorOperations::clear(frame.get(), 2 * fftSize);
+                if (length > 0)
+                    FloatVectorOperations::copy(frame.get(), impulseResponse.getReadPointer(ch, start), length);
+
+                fft.performRealOnlyForwardTransform(frame.get(), true);
+                deinterleave(frame.get(), getPartitionSpectrum(ch, p));
+            }
+        }
+
+        // only the last hop of every frame is free of wrap-around, see createWindow()
+        subFrameSize = hopSize;
+
+        // a frame reaches back through the delay line to the spectra of the partitionCount - 1 frames before it
+        setFrameDependency(FrameDependency::warmUp, partitionCount - 1);
+    }
+
+    ~UniformPartitionedConvolver()
+    {
+        // the worker of the tail convolvers reads the delay line
+        stopFrameWorker();
+    }
+
+    int getPartitionSize() const { return hopSize; }
+    int getNumPartitions() const { return partitionCount; }
+
+    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        Base::prepare(sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+
+        numDelayLineChannels = jmax(numInputChannels, numOutputChannels);
+        delayLine.allocate(numDelayLineChannels * partitionCount * 2 * numBins, true);
+        accumulator.allocate(2 * numBins, true);
+        delayLineHead = 0;
+    }
+
+    /** Clears the buffered audio and the delay line. Can be called from the audio thread unless the convolver uses
+        FrameScheduling::workerThread, see OverlapAddFftProcessorBase::reset() */
+    void reset()
+    {
+        Base::reset();
+
+        FloatVectorOperations::clear(delayLine.get(), delayLine.size());
+        delayLineHead = 0;
+    }
+
+private:
+    void createWindow()
+    {
+        window.createOverlapSave(fftSize, hopSize);
+    }
+
+    void processFrameInBuffer(const int maxNumChannels)
+    {
+        // the newest spectrum goes in front of the previous ones, so partition p pairs with the frame p hops ago
+        delayLineHead = delayLineHead > 0 ? delayLineHead - 1 : partitionCount - 1;
+
+        for (int ch = 0; ch < jmin(maxNumChannels, numDelayLineChannels); ++ch) {
+            float* frame = fftInOutBuffer.getWritePointer(ch);
+            fft.performRealOnlyForwardTransform(frame, true);
+            deinterleave(frame, getDelayLineSpectrum(ch, delayLineHead));
+
+            const int irChannel = jmin(ch, numIrChannels - 1);
+            FloatVectorOperations::clear(accumulator.get(), 2 * numBins);
+
+            for (int p = 0; p < partitionCount; ++p) {
+                const int slot = delayLineHead + p < partitionCount ? delayLineHead + p : delayLineHead + p - partitionCount;
+                multiplyAccumulate(accumulator.get(), getDelayLineSpectrum(ch, slot), getPartitionSpectrum(irChannel, p), numBins);
+            }
+
+            // inverse transform of the bins 0 to hopSize, as left by a forward transform of the non-negative frequencies
+            for (int k = 0; k <= hopSize; ++k) {
+                frame[2 * k] = accumulator[k];
+                frame[2 * k + 1] = accumulator[numBins + k];
+            }
+            fft.performRealOnlyInverseTransform(frame);
+        }
+    }
+
+    /** Copies the interleaved bins 0 to hopSize into a real and an imaginary block of numBins each */
+    void deinterleave(const float* interleaved, float* split) const noexcept
+    {
+        for (int k = 0; k <= hopSize; ++k) {
+            split[k] = interleaved[2 * k];
+            split[numBins + k] = interleaved[2 * k + 1];
+        }
+    }
+
+    /** accumulator += x * h, complex, on split spectra of numBins (a multiple of the SIMD width) */
+    static void multiplyAccumulate(float* accumulator, const float* x, const float* h, const int numBins) noexcept
+    {
+        float* accRe = accumulator;
+        float* accIm = accumulator + numBins;
+        const float* xRe = x;
+        const float* xIm = x + numBins;
+        const float* hRe = h;
+        const float* hIm = h + numBins;
+
+       #if JUCE_USE_SIMD
+        using Register = dsp::SIMDRegister<float>;
+        constexpr int lanes = (int)Register::SIMDNumElements;
+
+        for (int k = 0; k < numBins; k += lanes) {
+            const auto xr = Register::fromRawArray(xRe + k);
+            const auto xi = Register::fromRawArray(xIm + k);
+            const auto hr = Register::fromRawArray(hRe + k);
+            const auto hi = Register::fromRawArray(hIm + k);
+
+            (Register::fromRawArray(accRe + k) + xr * hr - xi * hi).copyToRawArray(accRe + k);
+            (Register::fromRawArray(accIm + k) + xr * hi + xi * hr).copyToRawArray(accIm + k);
+        }
+       #else
+        for (int k = 0; k < numBins; ++k) {
+            accRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+            accIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+        }
+       #endif
+    }
+
+    static int roundUp(const int value, const int multiple) { return (value + multiple - 1) / multiple * multiple; }
+
+    float* getPartitionSpectrum(const int irChannel, const int partition) noexcept
+    {
+        return partitionSpectra.get() + (irChannel * partitionCount + partition) * 2 * numBins;
+    }
+
+    float* getDelayLineSpectrum(const int ch, const int slot) noexcept
+    {
+        return delayLine.get() + (ch * partitionCount + slot) * 2 * numBins;
+    }
+
+    /** bins 0 to hopSize, rounded up to whole SIMD registers, the padding stays zero */
+    const int numBins;
+    int partitionCount = 0;
+    int numIrChannels = 0;
+    AlignedArray<float> partitionSpectra;
+
+    int numDelayLineChannels = 0;
+    AlignedArray<float> delayLine;
+    int delayLineHead = 0;
+    AlignedArray<float> accumulator;
+
+    JUCE_DECLARE_NON_COPYABLE(UniformPartitionedConvolver)
+};
+
+/**
+ Convolves with long impulse responses (seconds) at a latency of one short partition by splitting the response into
+ segments of growing partition sizes, each one a UniformPartitionedConvolver: the first segment uses the shortest
+ partitions and sets the latency, the later ones use up to four times longer partitions each, which cuts the number
+ of multiply-accumulates per sample, and run their transforms on their own worker thread.
+ Every segment starts late enough in the response that its higher latency is hidden, the rest is made up with
+ OverlapAddFftProcessor::setAdditionalLatency(). All segments read from one shared input ring and their outputs add up.
+ */
+class PartitionedConvolutionProcessor {
+public:
+    /**
+     @param minPartitionSizeAsPowerOf2 the partitions of the first segment, which are also the latency
+     @param maxPartitionSizeAsPowerOf2 the longest partitions, used for the tail of long responses
+     */
+    PartitionedConvolutionProcessor(const int minPartitionSizeAsPowerOf2 = 6, const int maxPartitionSizeAsPowerOf2 = 13)
+        : minPartitionSizeOrder(minPartitionSizeAsPowerOf2)
+        , maxPartitionSizeOrder(jmax(minPartitionSizeAsPowerOf2, maxPartitionSizeAsPowerOf2))
+    {
+    }
+
+    /**
+     Cuts the response into segments and transforms its partitions. This allocates and takes a while for long
+     responses, so don't call it from the audio thread or while process() runs. If the processor has been prepared
+     already, the new segments get prepared with the same settings.
+     @param impulseResponse one channel per output channel, or one for all of them
+     */
+    void loadImpulseResponse(const AudioBuffer<float>& impulseResponse)
+    {
+        segments.clear();
+        responseLength = impulseResponse.getNumSamples();
+
+        const int minPartitionSize = 1 << minPartitionSizeOrder;
+        int startSample = 0;
+        int order = minPartitionSizeOrder;
+
+        while (startSample < responseLength) {
+            const int partitionSize = 1 << order;
+            const int nextOrder = jmin(order + 2, maxPartitionSizeOrder);
+            int numPartitions = (responseLength - startSample + partitionSize - 1) / partitionSize;
+
+            if (nextOrder > order) {
+                // the next segment runs on a worker, with a latency of two of its partitions, of which the
+                // first segment covers one of ours
+                const int nextStart = 2 * (1 << nextOrder) - minPartitionSize;
+                numPartitions = jmin(numPartitions, jmax(1, (nextStart - startSample + partitionSize - 1) / partitionSize));
+            }
+
+            segments.push_back({ std::make_unique<UniformPartitionedConvolver>(order, impulseResponse, startSample, numPartitions), startSample });
+            startSample += numPartitions * partitionSize;
+            order = nextOrder;
+        }
+
+        if (maxBlockSize > 0)
+            prepare(sampleRate, maxBlockSize, numInpChannel, numOutChannel);
+    }
+
+    int getNumSegments() const { return (int)segments.size(); }
+
+    /** The convolver of a segment, e.g. to check its partitions */
+    UniformPartitionedConvolver& getSegment(const int index) { return *segments[(size_t)index].convolver; }
+
+    /** Returns the delay in samples between input and output: one partition of the first segment */
+    int getLatencySamples() const { return 1 << minPartitionSizeOrder; }
+
+    int getTailLengthSamples() const { return getLatencySamples() + responseLength; }
+
+    void prepare(const double newSampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        sampleRate = newSampleRate;
+        maxBlockSize = maximumBlockSize;
+        numInpChannel = numInputChannels;
+        numOutChannel = numOutputChannels;
+
+        int longestFrame = 0;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            auto& convolver = *segments[i].convolver;
+
+            convolver.setSharedInput(&sharedInput);
+            convolver.setFrameScheduling(i == 0 ? OverlapAddFftProcessor::FrameScheduling::audioThread : OverlapAddFftProcessor::FrameScheduling::workerThread);
+            convolver.setAdditionalLatency(0);
+            convolver.prepare(sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+
+            // a segment starting at startSample is due startSample samples after the first one
+            const int additionalLatency = segments[i].startSample + getLatencySamples() - convolver.getLatencySamples();
+            jassert(additionalLatency >= 0);
+            if (additionalLatency > 0) {
+                convolver.setAdditionalLatency(additionalLatency);
+                convolver.prepare(sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+            }
+
+            longestFrame = jmax(longestFrame, 2 * convolver.getPartitionSize());
+        }
+
+        sharedInput.setSize(numInputChannels, jmax(1, longestFrame));
+        segmentOutput.setSize(numOutputChannels, maximumBlockSize);
+    }
+
+    /** Clears all buffered audio, waits for the workers of the tail segments, so don't call it from the audio thread */
+    void reset()
+    {
+        sharedInput.clear();
+        for (auto& segment : segments)
+            segment.convolver->reset();
+    }
+
+    void process(const dsp::ProcessContextReplacing<float>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::ProcessContextNonReplacing<float>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::AudioBlock<const float>& inputBlock, dsp::AudioBlock<float>& outputBlock)
+    {
+        if (segments.empty()) {
+            outputBlock.clear();
+            return;
+        }
+
+        const auto inputBlockLength = (int)inputBlock.getNumSamples();
+        const auto numChIn = jmin(static_cast<int>(inputBlock.getNumChannels()), numInpChannel);
+        const auto numChOut = jmin(static_cast<int>(outputBlock.getNumChannels()), segmentOutput.getNumChannels());
+
+        // runs end at the next hop of any of the segments, and the input of a run is stored before any segment
+        // reads output into the (possibly same) memory
+        int i = 0;
+        while (i < inputBlockLength)
+        {
+            int numSamples = inputBlockLength - i;
+            for (auto& segment : segments)
+                numSamples = jmin(numSamples, segment.convolver->getSamplesToNextHop());
+
+            for (int ch = 0; ch < numChIn; ++ch)
+                sharedInput.write(ch, inputBlock.getChannelPointer(ch) + i, numSamples);
+            sharedInput.advance(numSamples);
+
+            auto outputRun = outputBlock.getSubBlock((size_t)i, (size_t)numSamples);
+            segments.front().convolver->processSharedInputRun(outputRun, numChIn);
+
+            auto segmentRun = dsp::AudioBlock<float>(segmentOutput).getSubsetChannelBlock(0, (size_t)numChOut).getSubBlock(0, (size_t)numSamples);
+            for (size_t s = 1; s < segments.size(); ++s) {
+                segments[s].convolver->processSharedInputRun(segmentRun, numChIn);
+                for (int ch = 0; ch < numChOut; ++ch)
+                    FloatVectorOperations::add(outputRun.getChannelPointer(ch), segmentRun.getChannelPointer(ch), numSamples);
+            }
+
+            i += numSamples;
+        }
+    }
+
+private:
+    struct Segment {
+        std::unique_ptr<UniformPartitionedConvolver> convolver;
+        int startSample;
+    };
+
+    const int minPartitionSizeOrder;
+    const int maxPartitionSizeOrder;
+    std::vector<Segment> segments;
+    int responseLength = 0;
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numInpChannel = 0;
+    int numOutChannel = 0;
+
+    MirroredRingBuffer<float> sharedInput;
+    AudioBuffer<float> segmentOutput;
+
+    JUCE_DECLARE_NON_COPYABLE(PartitionedConvolutionProcessor)
+};
@@ -13,6 +13,28 @@
 Test_Overlapping_FFTAudioProcessorEditor::Test_Overlapping_FFTAudioProcessorEditor (Test_Overlapping_FFTAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
+    addAndMakeVisible (exportButton);
+    addAndMakeVisible (resetButton);
+    exportButton.onClick = [this] { exportTrace(); };
+    resetButton.onClick = [this]
+    {
+        history.clear();
+        audioProcessor.getTelemetry().resetWorstCallback();
+        repaint();
+    };
+
+    if (ProcessorTelemetry::isEnabled)
+    {
+        drained.resize (4096);
+        lastUpdateTime = juce::Time::getMillisecondCounterHiRes();
+        startTimerHz (10);
+    }
+    else
+    {
+        exportButton.setEnabled (false);
+        resetButton.setEnabled (false);
+    }
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
     setSize (400, 300);
@@ -20,6 +42,7 @@ Test_Overlapping_FFTAudioProcessorEditor::Test_Overlapping_FFTAudioProcessorEdit
 
 Test_Overlapping_FFTAudioProcessorEditor::~Test_Overlapping_FFTAudioProcessorEditor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -30,11 +53,113 @@ void Test_Overlapping_FFTAudioProcessorEditor::paint (juce::Graphics& g)
 
     g.setColour (juce::Colours::white);
     g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
+
+    auto area = getLocalBounds().reduced (12).withTrimmedBottom (40);
+
+    if (! ProcessorTelemetry::isEnabled)
+    {
+        g.drawFittedText ("Callback telemetry is compiled out,\nbuild with OVERLAP_ADD_FFT_TELEMETRY=1 to enable it",
+                          area, juce::Justification::centred, 2);
+        return;
+    }
+
+    auto& telemetry = audioProcessor.getTelemetry();
+    const auto microseconds = [] (double value) { return juce::String (value, 1) + " us"; };
+
+    const std::pair<juce::String, juce::String> lines[] = {
+        { "Callbacks per second", juce::String (statistics.callbacksPerSecond, 1) },
+        { "Mean callback", microseconds (statistics.meanMicroseconds) },
+        { "Max callback", microseconds (statistics.maxMicroseconds) },
+        { "Worst callback", microseconds (ProcessorTelemetry::ticksToMicroseconds (telemetry.getWorstCallbackTicks())) },
+        { "Frames per callback", juce::String (statistics.meanFrames, 2) },
+        { "Frames / buffering", microseconds (statistics.meanFrameMicroseconds) + " / " + microseconds (statistics.meanBufferingMicroseconds) },
+        { "Load of the block time", juce::String (100.0 * statistics.load, 1) + " %" },
+        { "Recorded / dropped", juce::String ((int) history.size()) + " / " + juce::String ((juce::int64) telemetry.getNumDropped()) }
+    };
+
+    const int lineHeight = area.getHeight() / juce::numElementsInArray (lines);
+    for (auto& line : lines)
+    {
+        auto row = area.removeFromTop (lineHeight);
+        g.drawText (line.first, row.removeFromLeft (row.getWidth() / 2), juce::Justification::centredLeft);
+        g.drawText (line.second, row, juce::Justification::centredRight);
+    }
 }
 
 void Test_Overlapping_FFTAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto buttons = getLocalBounds().reduced (12).removeFromBottom (28);
+    exportButton.setBounds (buttons.removeFromLeft (buttons.getWidth() / 2).reduced (4, 0));
+    resetButton.setBounds (buttons.reduced (4, 0));
+}
+
+void Test_Overlapping_FFTAudioProcessorEditor::timerCallback()
+{
+    auto& telemetry = audioProcessor.getTelemetry();
+    const auto sampleRate = audioProcessor.getSampleRate();
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = 0.001 * (now - lastUpdateTime);
+    lastUpdateTime = now;
+
+    statistics = {};
+    double totalMicroseconds = 0.0, totalFrames = 0.0, totalFrameMicroseconds = 0.0, totalBlockMicroseconds = 0.0;
+
+    for (int numDrained = telemetry.drain (drained.data(), (int) drained.size()); numDrained > 0;
+         numDrained = telemetry.drain (drained.data(), (int) drained.size()))
+    {
+        for (int i = 0; i < numDrained; ++i)
+        {
+            const auto& record = drained[(size_t) i];
+            const auto callbackMicroseconds = ProcessorTelemetry::ticksToMicroseconds (record.callbackTicks);
+
+            totalMicroseconds += callbackMicroseconds;
+            totalFrames += record.numFrames;
+            totalFrameMicroseconds += ProcessorTelemetry::ticksToMicroseconds (record.frameTicks);
+            totalBlockMicroseconds += sampleRate > 0.0 ? 1.0e6 * record.numSamples / sampleRate : 0.0;
+            statistics.maxMicroseconds = juce::jmax (statistics.maxMicroseconds, callbackMicroseconds);
+        }
+
+        statistics.numCallbacks += numDrained;
+        history.insert (history.end(), drained.begin(), drained.begin() + numDrained);
+    }
+
+    // keep the latest callbacks for the export
+    if (history.size() > maxHistoryLength)
+        history.erase (history.begin(), history.end() - (std::ptrdiff_t) maxHistoryLength);
+
+    if (statistics.numCallbacks > 0)
+    {
+        statistics.callbacksPerSecond = statistics.numCallbacks / elapsedSeconds;
+        statistics.meanMicroseconds = totalMicroseconds / statistics.numCallbacks;
+        statistics.meanFrames = totalFrames / statistics.numCallbacks;
+        statistics.meanFrameMicroseconds = totalFrameMicroseconds / statistics.numCallbacks;
+        statistics.meanBufferingMicroseconds = statistics.meanMicroseconds - statistics.meanFrameMicroseconds;
+        statistics.load = totalBlockMicroseconds > 0.0 ? totalMicroseconds / totalBlockMicroseconds : 0.0;
+    }
+
+    repaint();
+}
+
+void Test_Overlapping_FFTAudioProcessorEditor::exportTrace()
+{
+    fileChooser = std::make_unique<juce::FileChooser> ("Export callback trace",
+                                                       juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("callbacks.json"),
+                                                       "*.json");
+
+    const auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                     | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    // the history keeps growing while the chooser is open, the trace holds the callbacks up to the click
+    fileChooser->launchAsync (flags, [this, callbacks = history] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        if (file == juce::File())
+            return;
+
+        file.deleteFile();
+        juce::FileOutputStream stream (file);
+        if (stream.openedOk())
+            ProcessorTelemetry::writeChromeTrace (stream, callbacks.data(), (int) callbacks.size());
+    });
 }
@@ -14,7 +14,8 @@
 //==============================================================================
 /**
 */
-class Test_Overlapping_FFTAudioProcessorEditor  : public juce::AudioProcessorEditor
+class Test_Overlapping_FFTAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                                  private juce::Timer
 {
 public:
     Test_Overlapping_FFTAudioProcessorEditor (Test_Overlapping_FFTAudioProcessor&);
@@ -25,9 +26,38 @@ public:
     void resized() override;
 
 private:
+    /** Drains the telemetry of the processor into the history and updates the statistics */
+    void timerCallback() override;
+
+    /** Lets the user pick a file and writes the history there as Chrome trace JSON */
+    void exportTrace();
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     Test_Overlapping_FFTAudioProcessor& audioProcessor;
 
+    /** The callbacks drained during the last timer interval */
+    struct CallbackStatistics
+    {
+        int numCallbacks = 0;
+        double callbacksPerSecond = 0.0;
+        double meanMicroseconds = 0.0;
+        double maxMicroseconds = 0.0;
+        double meanFrames = 0.0;
+        double meanFrameMicroseconds = 0.0;
+        double meanBufferingMicroseconds = 0.0;
+        double load = 0.0;
+    };
+    CallbackStatistics statistics;
+    double lastUpdateTime = 0.0;
+
+    std::vector<ProcessorTelemetry::CallbackRecord> drained;
+    std::vector<ProcessorTelemetry::CallbackRecord> history;
+    static constexpr size_t maxHistoryLength = 1 << 16;
+
+    juce::TextButton exportButton { "Export trace..." };
+    juce::TextButton resetButton { "Reset" };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Test_Overlapping_FFTAudioProcessorEditor)
 };
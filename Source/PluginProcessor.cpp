@@ -22,10 +22,19 @@ Test_Overlapping_FFTAudioProcessor::Test_Overlapping_FFTAudioProcessor()
                        )
 #endif
 {
+    // the choices are the configurations of the spectral processors, which start with the 1024 one
+    addParameter (fftConfiguration = new juce::AudioParameterChoice ("fftSize", "FFT Size", { "256", "1024", "4096" }, 1));
+    addParameter (lowLatency = new juce::AudioParameterBool ("lowLatency", "Low Latency", false));
+
+    spectralDynamicProcessor.setTelemetry (&telemetry);
+    doubleSpectralDynamicProcessor.setTelemetry (&telemetry);
+
+    startTimerHz (10);
 }
 
 Test_Overlapping_FFTAudioProcessor::~Test_Overlapping_FFTAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -63,7 +72,10 @@ bool Test_Overlapping_FFTAudioProcessor::isMidiEffect() const
 
 double Test_Overlapping_FFTAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    const auto sampleRate = getSampleRate();
+    int tailSamples = 0;
+    withActiveProcessor ([&tailSamples] (auto& processor) { tailSamples = processor.getTailLengthSamples(); });
+    return sampleRate > 0.0 ? tailSamples / sampleRate : 0.0;
 }
 
 int Test_Overlapping_FFTAudioProcessor::getNumPrograms()
@@ -93,7 +105,41 @@ void Test_Overlapping_FFTAudioProcessor::changeProgramName (int index, const juc
 //==============================================================================
 void Test_Overlapping_FFTAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    spectralDynamicProcessor.prepare(sampleRate, samplesPerBlock, 2, 2);
+    prepareSpectralDynamics (sampleRate, samplesPerBlock);
+}
+
+void Test_Overlapping_FFTAudioProcessor::prepareSpectralDynamics (double sampleRate, int samplesPerBlock)
+{
+    preparedLowLatency = lowLatency->get();
+
+    const auto setSubFrameSize = [this] (auto& processor)
+    {
+        processor.setSubFrameSize (preparedLowLatency ? 2 * processor.getHopSize() : processor.getFftSize());
+    };
+
+    spectralDynamicProcessor.forEachProcessor (setSubFrameSize);
+    doubleSpectralDynamicProcessor.forEachProcessor (setSubFrameSize);
+
+    if (isUsingDoublePrecision())
+        doubleSpectralDynamicProcessor.prepare(sampleRate, samplesPerBlock, 2, 2);
+    else
+        spectralDynamicProcessor.prepare(sampleRate, samplesPerBlock, 2, 2);
+
+    withActiveProcessor ([this] (auto& processor) { processorLatency = processor.getLatencySamples(); });
+    updateLatency();
+}
+
+void Test_Overlapping_FFTAudioProcessor::timerCallback()
+{
+    updateLatency();
+
+    // the sub-frame size can't change while processing, and the host doesn't prepare again for a parameter
+    if (lowLatency->get() == preparedLowLatency || getSampleRate() <= 0.0)
+        return;
+
+    suspendProcessing (true);
+    prepareSpectralDynamics (getSampleRate(), getBlockSize());
+    suspendProcessing (false);
 }
 
 void Test_Overlapping_FFTAudioProcessor::releaseResources()
@@ -129,6 +175,22 @@ bool Test_Overlapping_FFTAudioProcessor::isBusesLayoutSupported (const BusesLayo
 #endif
 
 void Test_Overlapping_FFTAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSpectralDynamics (buffer, spectralDynamicProcessor);
+}
+
+void Test_Overlapping_FFTAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSpectralDynamics (buffer, doubleSpectralDynamicProcessor);
+}
+
+bool Test_Overlapping_FFTAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType, typename ProcessorType>
+void Test_Overlapping_FFTAudioProcessor::processSpectralDynamics (juce::AudioBuffer<SampleType>& buffer, ProcessorType& processor)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -137,10 +199,24 @@ void Test_Overlapping_FFTAudioProcessor::processBlock (juce::AudioBuffer<float>&
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-	dsp::AudioBlock<float> audioBlock (buffer);
-	dsp::ProcessContextReplacing<float> context (audioBlock);
-	spectralDynamicProcessor.process (context);
+	// a switch only starts if the index differs from the active configuration
+	processor.setConfiguration (fftConfiguration->getIndex());
+
+	dsp::AudioBlock<SampleType> audioBlock (buffer);
+	dsp::ProcessContextReplacing<SampleType> context (audioBlock);
+	processor.process (context);
 	// buffer.applyGain(1.0f / (1024 / 128 / 2));
+
+	// the latency changes once a switch of the FFT configuration has finished. The host is told from the timer,
+	// setLatencySamples() calls into the host, which may lock or allocate
+	processorLatency.store (processor.getLatencySamples(), std::memory_order_relaxed);
+}
+
+void Test_Overlapping_FFTAudioProcessor::updateLatency()
+{
+    const int latency = processorLatency.load (std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples (latency);
 }
 
 //==============================================================================
@@ -157,15 +233,31 @@ juce::AudioProcessorEditor* Test_Overlapping_FFTAudioProcessor::createEditor()
 //==============================================================================
 void Test_Overlapping_FFTAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    juce::XmlElement state ("Test_Overlapping_FFT");
+    state.setAttribute ("fftSize", fftConfiguration->getIndex());
+    state.setAttribute ("lowLatency", lowLatency->get());
+    copyXmlToBinary (state, destData);
 }
 
 void Test_Overlapping_FFTAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // the low latency mode takes effect with the next timer callback, see timerCallback()
+    if (auto state = getXmlFromBinary (data, sizeInBytes))
+    {
+        setFftConfiguration (state->getIntAttribute ("fftSize", fftConfiguration->getIndex()));
+        setLowLatencyMode (state->getBoolAttribute ("lowLatency", lowLatency->get()));
+    }
+}
+
+//==============================================================================
+void Test_Overlapping_FFTAudioProcessor::setFftConfiguration (int index)
+{
+    *fftConfiguration = juce::jlimit (0, fftConfiguration->choices.size() - 1, index);
+}
+
+void Test_Overlapping_FFTAudioProcessor::setLowLatencyMode (bool shouldUseLowLatency)
+{
+    *lowLatency = shouldUseLowLatency;
 }
 
 //==============================================================================
@@ -10,11 +10,14 @@
 
 #include <JuceHeader.h>
 #include "SpectralDynamicProcessor.h"
+#include "ReconfigurableFftProcessor.h"
+#include "ProcessorTelemetry.h"
 
 //==============================================================================
 /**
 */
-class Test_Overlapping_FFTAudioProcessor  : public juce::AudioProcessor
+class Test_Overlapping_FFTAudioProcessor  : public juce::AudioProcessor,
+                                            private juce::Timer
 {
 public:
     //==============================================================================
@@ -30,6 +33,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -54,9 +59,60 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    /** Switches the FFT size of the spectral processor, fading through silence without reallocation:
+        0 = 256 (low latency), 1 = 1024, 2 = 4096 (high resolution). Sets the "fftSize" parameter */
+    void setFftConfiguration (int index);
+
+    /** Synthesises only a sub-frame of two hops per frame, which cuts the latency of the 1024 configuration
+        from 1024 to 256 samples. Sets the "lowLatency" parameter, the processors are prepared again on the
+        message thread, with processing suspended meanwhile */
+    void setLowLatencyMode (bool shouldUseLowLatency);
+
+    /** The callback timing of the spectral processor, drained by the editor. Only records anything if the
+        project sets OVERLAP_ADD_FFT_TELEMETRY=1 */
+    ProcessorTelemetry& getTelemetry() { return telemetry; }
+
 private:
+    /** Prepares the processor for the precision the host uses, with the current low latency mode */
+    void prepareSpectralDynamics (double sampleRate, int samplesPerBlock);
+
+    /** On the message thread: reports a new latency to the host, and prepares again once the low latency mode
+        has changed */
+    void timerCallback() override;
+
+    template <typename SampleType, typename ProcessorType>
+    void processSpectralDynamics (juce::AudioBuffer<SampleType>& buffer, ProcessorType& processor);
+
+    /** Calls function with the processor for the precision the host uses, float or double */
+    template <typename Function>
+    void withActiveProcessor (Function&& function) const
+    {
+        if (isUsingDoublePrecision())
+            function (doubleSpectralDynamicProcessor);
+        else
+            function (spectralDynamicProcessor);
+    }
+
+    /** Reports processorLatency to the host if it has changed, not from the audio thread */
+    void updateLatency();
+
+    // owned by the processor, see addParameter()
+    juce::AudioParameterChoice* fftConfiguration;
+    juce::AudioParameterBool* lowLatency;
+
+    // the latency of the active processor, changes on the audio thread once a switch of the FFT size has finished
+    std::atomic<int> processorLatency { 0 };
+
+    // the low latency mode the processors are prepared with, some hosts prepare on another thread than the timer's
+    std::atomic<bool> preparedLowLatency { false };
+
+	// only the one matching the processing precision is prepared. The double one keeps the spectra in float,
+	// but takes double audio and accumulates the overlap-add in double
+	ReconfigurableFftProcessor<SpectralDynamicProcessor> spectralDynamicProcessor { { { 8, 2 }, { 10, 3 }, { 12, 3 } }, 1 };
+	ReconfigurableFftProcessor<BasicSpectralDynamicProcessor<double>> doubleSpectralDynamicProcessor { { { 8, 2 }, { 10, 3 }, { 12, 3 } }, 1 };
 
-	SpectralDynamicProcessor spectralDynamicProcessor;
+	ProcessorTelemetry telemetry;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Test_Overlapping_FFTAudioProcessor)
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    ProcessorTelemetry.h
+    Created: 20 Oct 2026 4:12:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ Switches the instrumentation of the processors on (1) or off (0), can be set as a preprocessor definition
+ of the project. Switched off, ProcessorTelemetry keeps its interface but all of its audio thread calls are
+ empty and compile to nothing.
+ */
+#ifndef OVERLAP_ADD_FFT_TELEMETRY
+ #define OVERLAP_ADD_FFT_TELEMETRY 0
+#endif
+
+/**
+ Timing of the audio callbacks of a processor, recorded on the audio thread without locks or allocation.
+
+ Every callback writes one CallbackRecord into a wait-free single-producer/single-consumer ring, which a
+ non-audio thread (e.g. a timer of the editor) drains. If the ring is full, the record is dropped and counted
+ instead; the worst callback time is kept separately, so it isn't lost with a dropped record.
+
+ A record splits the callback time into the frame time, spent in the transforms and frame callbacks, and the
+ rest, spent buffering: the ring buffers, windowing and overlap-add. Callback scopes nest, only the outermost
+ one records, so a host callback that runs several processors (e.g. during a switch of
+ ReconfigurableFftProcessor) is a single record. All audio thread calls have to come from one thread.
+
+ The times are ticks of Time::getHighResolutionTicks(), see ticksToMicroseconds().
+ @code
+ ProcessorTelemetry telemetry;
+ processor.setTelemetry (&telemetry);
+ ...
+ ProcessorTelemetry::CallbackRecord records[256];
+ const int numRecords = telemetry.drain (records, 256);   // on the message thread
+ @endcode
+ */
+class ProcessorTelemetry {
+public:
+    struct CallbackRecord {
+        /** Time::getHighResolutionTicks() at the start of the callback */
+        int64 startTicks = 0;
+        int64 callbackTicks = 0;
+        /** the part of callbackTicks spent on frames, the rest is buffering */
+        int64 frameTicks = 0;
+        int numSamples = 0;
+        int numFrames = 0;
+    };
+
+    static constexpr bool isEnabled = OVERLAP_ADD_FFT_TELEMETRY != 0;
+
+    /** @param numRecords the size of the ring, has to be a power of two. Nothing is allocated when disabled */
+    explicit ProcessorTelemetry(const int numRecords = 4096)
+    {
+        jassert(isPowerOfTwo(numRecords));
+        if (isEnabled)
+            records.resize((size_t)numRecords);
+    }
+
+    // ====== audio thread
+#if OVERLAP_ADD_FFT_TELEMETRY
+    void beginCallback(const int numSamples) noexcept
+    {
+        if (callbackDepth++ > 0)
+            return;
+
+        current = CallbackRecord();
+        current.numSamples = numSamples;
+        current.startTicks = Time::getHighResolutionTicks();
+    }
+
+    void endCallback() noexcept
+    {
+        if (--callbackDepth > 0)
+            return;
+
+        current.callbackTicks = Time::getHighResolutionTicks() - current.startTicks;
+
+        // only the audio thread raises it, so a plain store is enough
+        if (current.callbackTicks > worstCallbackTicks.load(std::memory_order_relaxed))
+            worstCallbackTicks.store(current.callbackTicks, std::memory_order_relaxed);
+
+        const auto index = numWritten.load(std::memory_order_relaxed);
+        if (index - numRead.load(std::memory_order_acquire) >= (uint32_t)records.size()) {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        records[index & (uint32_t)(records.size() - 1)] = current;
+        numWritten.store(index + 1, std::memory_order_release);
+    }
+
+    void beginFrames() noexcept { frameStartTicks = Time::getHighResolutionTicks(); }
+
+    /** @param numFrames the number of frames finished since beginFrames() */
+    void endFrames(const int numFrames) noexcept
+    {
+        current.frameTicks += Time::getHighResolutionTicks() - frameStartTicks;
+        current.numFrames += numFrames;
+    }
+#else
+    void beginCallback(const int) noexcept { }
+    void endCallback() noexcept { }
+    void beginFrames() noexcept { }
+    void endFrames(const int) noexcept { }
+#endif
+
+    /** Times a callback, does nothing for a nullptr */
+    class ScopedCallback {
+    public:
+#if OVERLAP_ADD_FFT_TELEMETRY
+        ScopedCallback(ProcessorTelemetry* telemetryToUse, const int numSamples) noexcept : telemetry(telemetryToUse)
+        {
+            if (telemetry != nullptr)
+                telemetry->beginCallback(numSamples);
+        }
+
+        ~ScopedCallback()
+        {
+            if (telemetry != nullptr)
+                telemetry->endCallback();
+        }
+
+    private:
+        ProcessorTelemetry* const telemetry;
+#else
+        ScopedCallback(ProcessorTelemetry*, const int) noexcept { }
+#endif
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    /** Counts the time of its scope as frame time of the current callback, does nothing for a nullptr */
+    class ScopedFrames {
+    public:
+#if OVERLAP_ADD_FFT_TELEMETRY
+        ScopedFrames(ProcessorTelemetry* telemetryToUse, const int numFramesToCount) noexcept
+            : telemetry(telemetryToUse)
+            , numFrames(numFramesToCount)
+        {
+            if (telemetry != nullptr)
+                telemetry->beginFrames();
+        }
+
+        ~ScopedFrames()
+        {
+            if (telemetry != nullptr)
+                telemetry->endFrames(numFrames);
+        }
+
+    private:
+        ProcessorTelemetry* const telemetry;
+        const int numFrames;
+#else
+        ScopedFrames(ProcessorTelemetry*, const int) noexcept { }
+#endif
+        JUCE_DECLARE_NON_COPYABLE(ScopedFrames)
+    };
+
+    // ====== consumer (one non-audio thread)
+    /** Moves up to maxNumRecords of the oldest records into destination and returns their number */
+    int drain(CallbackRecord* destination, const int maxNumRecords) noexcept
+    {
+        if (! isEnabled)
+            return 0;
+
+        const auto first = numRead.load(std::memory_order_relaxed);
+        const auto available = (int)(numWritten.load(std::memory_order_acquire) - first);
+        const auto numRecords = jmin(available, maxNumRecords);
+
+        for (int i = 0; i < numRecords; ++i)
+            destination[i] = records[(first + (uint32_t)i) & (uint32_t)(records.size() - 1)];
+
+        numRead.store(first + (uint32_t)numRecords, std::memory_order_release);
+        return numRecords;
+    }
+
+    /** The longest callback since construction or resetWorstCallback(), including dropped ones */
+    int64 getWorstCallbackTicks() const noexcept { return worstCallbackTicks.load(std::memory_order_relaxed); }
+
+    /** May miss a new worst case the audio thread records at the same moment */
+    void resetWorstCallback() noexcept { worstCallbackTicks.store(0, std::memory_order_relaxed); }
+
+    /** The number of records lost to a full ring */
+    uint32_t getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+    static double ticksToMicroseconds(const int64 ticks) noexcept
+    {
+        return 1.0e6 * (double)ticks / (double)Time::getHighResolutionTicksPerSecond();
+    }
+
+    /**
+     Writes records in the Chrome trace event format (chrome://tracing, Perfetto): every callback is a complete
+     event with its numbers as arguments, and the frame and buffering time are counters, drawn as a stacked graph.
+     The timestamps are relative to the first record.
+     */
+    static void writeChromeTrace(OutputStream& stream, const CallbackRecord* callbacks, const int numRecords)
+    {
+        const int64 origin = numRecords > 0 ? callbacks[0].startTicks : 0;
+        const auto time = [](const double microseconds) { return String(microseconds, 3); };
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        for (int i = 0; i < numRecords; ++i) {
+            const auto& record = callbacks[i];
+            const auto start = ticksToMicroseconds(record.startTicks - origin);
+            const auto frameTime = ticksToMicroseconds(record.frameTicks);
+            const auto bufferingTime = ticksToMicroseconds(record.callbackTicks - record.frameTicks);
+
+            stream << (i > 0 ? ",\n" : "\n")
+                   << "{\"name\":\"callback\",\"cat\":\"audio\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                   << ",\"ts\":" << time(start) << ",\"dur\":" << time(ticksToMicroseconds(record.callbackTicks))
+                   << ",\"args\":{\"samples\":" << record.numSamples << ",\"frames\":" << record.numFrames
+                   << ",\"frame us\":" << time(frameTime) << ",\"buffering us\":" << time(bufferingTime) << "}},\n"
+                   << "{\"name\":\"callback time (us)\",\"ph\":\"C\",\"pid\":1,\"ts\":" << time(start)
+                   << ",\"args\":{\"frames\":" << time(frameTime) << ",\"buffering\":" << time(bufferingTime) << "}}";
+        }
+
+        stream << "\n]}\n";
+    }
+
+private:
+    std::vector<CallbackRecord> records;
+    std::atomic<uint32_t> numWritten { 0 };
+    std::atomic<uint32_t> numRead { 0 };
+    std::atomic<uint32_t> numDropped { 0 };
+    std::atomic<int64> worstCallbackTicks { 0 };
+
+#if OVERLAP_ADD_FFT_TELEMETRY
+    // audio thread only
+    CallbackRecord current;
+    int64 frameStartTicks = 0;
+    int callbackDepth = 0;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(ProcessorTelemetry)
+};
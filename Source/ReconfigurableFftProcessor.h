@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    ReconfigurableFftProcessor.h
+    Created: 18 Oct 2026 2:37:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorTelemetry.h"
+
+using namespace juce;
+
+/**
+ Runs one of several FFT configurations (fftSize and hop) of a processor and switches between them at
+ runtime. One ProcessorType instance per configuration is created in the constructor and all of them are
+ prepared in prepare(), so a switch never allocates or frees memory on the audio thread.
+
+ A switch starts at the beginning of a block: the incoming processor is reset and fed the input alongside
+ the active one. The active output fades out to silence, ending when the latency of the incoming processor has
+ passed and its output is valid, then the incoming output fades in. The latency changes with the configuration,
+ getLatencySamples() reports the one of the active configuration.
+
+ The two outputs are never mixed: they are delayed by different latencies, so a crossfade would sum two copies of
+ the signal that are offset in time (comb filtering), and jump by the latency difference at its end. Delaying the
+ lower latency output during the fade would only move that jump to the start or the end of the fade, while in
+ silence it is inaudible.
+
+ ProcessorType needs a (fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2) constructor and prepare(), reset(),
+ process() and getLatencySamples() like OverlapAddFftProcessor, and processes ProcessorType::SampleType.
+ setTelemetry() needs ProcessorType::setTelemetry() as well.
+
+ A switch resets the incoming processor on the audio thread, so the processors can't use
+ FrameScheduling::workerThread, where reset() waits for the worker.
+ */
+template <typename ProcessorType>
+class ReconfigurableFftProcessor {
+public:
+    using SampleType = typename ProcessorType::SampleType;
+
+    struct Configuration {
+        int fftSizeAsPowerOf2;
+        int hopSizeDividerAsPowerOf2;
+    };
+
+    ReconfigurableFftProcessor(std::initializer_list<Configuration> configurations, const int initialConfiguration = 0)
+        : activeConfiguration(initialConfiguration)
+        , requestedConfiguration(initialConfiguration)
+    {
+        for (auto& configuration : configurations)
+            processors.push_back(std::make_unique<ProcessorType>(configuration.fftSizeAsPowerOf2, configuration.hopSizeDividerAsPowerOf2));
+
+        jassert(isPositiveAndBelow(initialConfiguration, getNumConfigurations()));
+    }
+
+    int getNumConfigurations() const { return (int)processors.size(); }
+
+    /** The processor of a configuration, e.g. to set its parameters */
+    ProcessorType& getProcessor(const int index) { return *processors[(size_t)index]; }
+
+    /** Calls function(processor) for the processors of all configurations */
+    template <typename Function>
+    void forEachProcessor(Function&& function)
+    {
+        for (auto& processor : processors)
+            function(*processor);
+    }
+
+    /** Sets the length of the fade out and of the fade in of a switch, don't call this during a switch */
+    void setCrossfadeLength(const int numSamples) { crossfadeLength = jmax(1, numSamples); }
+
+    /** Requests a switch to another configuration. Can be called from any thread, the switch starts with the next
+        block, or once a running switch has finished. */
+    void setConfiguration(const int index)
+    {
+        jassert(isPositiveAndBelow(index, getNumConfigurations()));
+        requestedConfiguration.store(index);
+    }
+
+    /** The configuration that is (or, during a switch, still is) audible */
+    int getActiveConfiguration() const { return activeConfiguration.load(); }
+
+    int getLatencySamples() const { return processors[(size_t)activeConfiguration.load()]->getLatencySamples(); }
+
+    /** The longest tail of all configurations, so it holds during and after a switch */
+    int getTailLengthSamples() const
+    {
+        int tail = 0;
+        for (auto& processor : processors)
+            tail = jmax(tail, processor->getTailLengthSamples());
+        return tail;
+    }
+
+    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        for (auto& processor : processors) {
+            // reset() would block the audio thread on the worker, see the class description
+            jassert(processor->getFrameScheduling() != ProcessorType::FrameScheduling::workerThread);
+            processor->prepare(sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+        }
+
+        maxBlockSize = maximumBlockSize;
+        inputCopy.setSize(numInputChannels, maximumBlockSize);
+        incomingOutput.setSize(numOutputChannels, maximumBlockSize);
+        fadeOut.allocate((size_t)maximumBlockSize, false);
+        fadeIn.allocate((size_t)maximumBlockSize, false);
+
+        incomingConfiguration = -1;
+    }
+
+    void reset()
+    {
+        for (auto& processor : processors)
+            processor->reset();
+
+        incomingConfiguration = -1;
+    }
+
+    /** Records the timing into telemetry (see ProcessorTelemetry), one record per call of process() for both
+        processors of a switch together, or stops recording for a nullptr. Don't call this while processing */
+    void setTelemetry(ProcessorTelemetry* telemetryToUse)
+    {
+        telemetry = telemetryToUse;
+        for (auto& processor : processors)
+            processor->setTelemetry(telemetryToUse);
+    }
+
+    void process(const dsp::ProcessContextReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::ProcessContextNonReplacing<SampleType>& context)
+    {
+        process(context.getInputBlock(), context.getOutputBlock());
+    }
+
+    void process(const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
+    {
+        // the scratch buffers hold one block of the size given to prepare()
+        const auto numSamples = (int)inputBlock.getNumSamples();
+        const ProcessorTelemetry::ScopedCallback callbackTiming(telemetry, numSamples);
+        for (int start = 0; start < numSamples; start += maxBlockSize) {
+            const auto length = (size_t)jmin(maxBlockSize, numSamples - start);
+            auto outputRun = outputBlock.getSubBlock((size_t)start, length);
+            processRun(inputBlock.getSubBlock((size_t)start, length), outputRun);
+        }
+    }
+
+private:
+    void processRun(const dsp::AudioBlock<const SampleType>& inputBlock, dsp::AudioBlock<SampleType>& outputBlock)
+    {
+        if (incomingConfiguration < 0) {
+            const int requested = requestedConfiguration.load();
+            if (requested != activeConfiguration.load()) {
+                incomingConfiguration = requested;
+                processors[(size_t)incomingConfiguration]->reset();
+                samplesSinceSwitch = 0;
+            }
+        }
+
+        auto& active = *processors[(size_t)activeConfiguration.load()];
+
+        if (incomingConfiguration < 0) {
+            active.process(inputBlock, outputBlock);
+            return;
+        }
+
+        auto& incoming = *processors[(size_t)incomingConfiguration];
+        const auto numSamples = (int)inputBlock.getNumSamples();
+        const auto numChIn = jmin((int)inputBlock.getNumChannels(), inputCopy.getNumChannels());
+        const auto numChOut = jmin((int)outputBlock.getNumChannels(), incomingOutput.getNumChannels());
+
+        // both processors need the input, which the first one may overwrite (replacing context)
+        for (int ch = 0; ch < numChIn; ++ch)
+            FloatVectorOperations::copy(inputCopy.getWritePointer(ch), inputBlock.getChannelPointer((size_t)ch), numSamples);
+
+        const dsp::AudioBlock<const SampleType> input(dsp::AudioBlock<SampleType>(inputCopy).getSubsetChannelBlock(0, (size_t)numChIn).getSubBlock(0, (size_t)numSamples));
+        auto incomingBlock = dsp::AudioBlock<SampleType>(incomingOutput).getSubsetChannelBlock(0, (size_t)numChOut).getSubBlock(0, (size_t)numSamples);
+
+        active.process(input, outputBlock);
+        incoming.process(input, incomingBlock);
+
+        // the active output is silent once the incoming one is valid (or the fade out is over, if that's later),
+        // then the incoming output fades in
+        const int silenceStart = jmax(incoming.getLatencySamples(), crossfadeLength);
+        for (int i = 0; i < numSamples; ++i) {
+            const int position = samplesSinceSwitch + i;
+            fadeOut[i] = jlimit(SampleType(0), SampleType(1), (SampleType)(silenceStart - position) / (SampleType)crossfadeLength);
+            fadeIn[i] = jlimit(SampleType(0), SampleType(1), (SampleType)(position + 1 - silenceStart) / (SampleType)crossfadeLength);
+        }
+
+        // out = fadeOut * out + fadeIn * incoming, only one of the two is above zero at a time
+        for (int ch = 0; ch < numChOut; ++ch) {
+            SampleType* out = outputBlock.getChannelPointer((size_t)ch);
+            SampleType* in = incomingBlock.getChannelPointer((size_t)ch);
+            FloatVectorOperations::multiply(out, fadeOut.get(), numSamples);
+            FloatVectorOperations::multiply(in, fadeIn.get(), numSamples);
+            FloatVectorOperations::add(out, in, numSamples);
+        }
+
+        samplesSinceSwitch += numSamples;
+        if (samplesSinceSwitch >= silenceStart + crossfadeLength) {
+            activeConfiguration.store(incomingConfiguration);
+            incomingConfiguration = -1;
+        }
+    }
+
+    std::vector<std::unique_ptr<ProcessorType>> processors;
+
+    std::atomic<int> activeConfiguration;
+    std::atomic<int> requestedConfiguration;
+    int incomingConfiguration = -1;
+    int samplesSinceSwitch = 0;
+    int crossfadeLength = 1024;
+
+    int maxBlockSize = 0;
+    AudioBuffer<SampleType> inputCopy;
+    AudioBuffer<SampleType> incomingOutput;
+    HeapBlock<SampleType> fadeOut;
+    HeapBlock<SampleType> fadeIn;
+
+    ProcessorTelemetry* telemetry = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(ReconfigurableFftProcessor)
+};
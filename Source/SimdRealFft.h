@@ -0,0 +1,331 @@
+/*
+  ==============================================================================
+
+    SimdRealFft.h
+    Created: 17 Oct 2026 8:20:00pm
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AlignedArray.h"
+
+using namespace juce;
+
+/**
+ Real-only FFT using the same in-place data layout and scaling as juce::dsp::FFT, so both can be
+ swapped freely: the forward transform takes fftSize real samples in a buffer of 2 * fftSize floats
+ and returns interleaved complex bins, the inverse one takes bins 0 ... fftSize / 2 and returns
+ fftSize real samples scaled by 1 / fftSize.
+
+ Internally it runs a complex FFT of half the size on the even/odd samples packed as real/imaginary
+ parts and untangles the two spectra afterwards. The complex FFT works on split real/imaginary
+ arrays with contiguous per-stage twiddle tables, so every butterfly loop is a plain unit-stride loop
+ the compiler turns into SIMD code. The split arrays live in the upper half of the caller's buffer,
+ which is why the transform needs no scratch memory and can run on several threads at once.
+
+ The batch variants run the very same code on SIMD registers, transforming one channel per lane.
+ FloatType is float or double; in double precision the tables are double too, and a SIMD register
+ holds half as many channels.
+ */
+template <typename FloatType>
+class SimdRealFft {
+public:
+    explicit SimdRealFft(const int order)
+        : size(1 << order)
+        , complexSize(jmax(1, size / 2))
+    {
+        jassert(order > 0);
+
+        // bit-reversal permutation of the complex FFT
+        bitReversed.allocate((size_t)complexSize, false);
+        int numBits = 0;
+        while ((1 << numBits) < complexSize)
+            ++numBits;
+        for (int n = 0; n < complexSize; ++n) {
+            int reversed = 0;
+            for (int bit = 0; bit < numBits; ++bit)
+                reversed |= ((n >> bit) & 1) << (numBits - 1 - bit);
+            bitReversed[n] = reversed;
+        }
+
+        // twiddles of the stage with butterfly distance h are at [h, 2h)
+        stageCos.allocate(complexSize, true);
+        stageSin.allocate(complexSize, true);
+        for (int h = 1; h < complexSize; h *= 2)
+            for (int j = 0; j < h; ++j) {
+                const double angle = MathConstants<double>::pi * j / h;
+                stageCos[h + j] = (FloatType)std::cos(angle);
+                stageSin[h + j] = (FloatType)-std::sin(angle);
+            }
+
+        // twiddles to untangle the even/odd spectra
+        splitCos.allocate(complexSize + 1, false);
+        splitSin.allocate(complexSize + 1, false);
+        for (int k = 0; k <= complexSize; ++k) {
+            const double angle = MathConstants<double>::twoPi * k / size;
+            splitCos[k] = (FloatType)std::cos(angle);
+            splitSin[k] = (FloatType)std::sin(angle);
+        }
+    }
+
+    int getSize() const noexcept { return size; }
+
+    void performRealOnlyForwardTransform(FloatType* d, const bool onlyCalculateNonNegativeFrequencies = false) const noexcept
+    {
+        forward(d, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransform(FloatType* d) const noexcept
+    {
+        inverse(d);
+    }
+
+    /** The number of channels the batch transforms work on at once, one per SIMD lane */
+   #if JUCE_USE_SIMD
+    static constexpr int batchSize = (int)dsp::SIMDRegister<FloatType>::SIMDNumElements;
+   #else
+    static constexpr int batchSize = 1;
+   #endif
+
+    /**
+     Transforms batchSize channels at once. The data is channel-interleaved: the value at index i of the
+     single-channel layout lives at d[i * batchSize + channel], so the buffer holds 2 * fftSize * batchSize
+     values and has to be SIMD aligned. Every butterfly then works on full vector registers instead of
+     single values.
+     */
+    void performRealOnlyForwardTransformBatch(FloatType* d, const bool onlyCalculateNonNegativeFrequencies = false) const noexcept
+    {
+       #if JUCE_USE_SIMD
+        jassert(dsp::SIMDRegister<FloatType>::isSIMDAligned(d));
+        forward(reinterpret_cast<dsp::SIMDRegister<FloatType>*>(d), onlyCalculateNonNegativeFrequencies);
+       #else
+        forward(d, onlyCalculateNonNegativeFrequencies);
+       #endif
+    }
+
+    /** Inverse of performRealOnlyForwardTransformBatch(), with the same channel-interleaved layout */
+    void performRealOnlyInverseTransformBatch(FloatType* d) const noexcept
+    {
+       #if JUCE_USE_SIMD
+        jassert(dsp::SIMDRegister<FloatType>::isSIMDAligned(d));
+        inverse(reinterpret_cast<dsp::SIMDRegister<FloatType>*>(d));
+       #else
+        inverse(d);
+       #endif
+    }
+
+protected:
+    /** Forward transform on either single values or SIMD registers holding one channel per lane */
+    template <typename Value>
+    void forward(Value* d, const bool onlyCalculateNonNegativeFrequencies) const noexcept
+    {
+        const int M = complexSize;
+        Value* re = d + size;
+        Value* im = re + M;
+
+        // z[n] = x[2n] + i x[2n + 1], in bit-reversed order
+        for (int n = 0; n < M; ++n) {
+            const int source = 2 * bitReversed[n];
+            re[n] = d[source];
+            im[n] = d[source + 1];
+        }
+
+        performComplexStages(re, im);
+
+        // X[k] = E[k] + W^k O[k], with E and O the spectra of the even and odd samples
+        const Value dc = re[0];
+        const Value dcImag = im[0];
+
+        for (int k = 1; k < M; ++k) {
+            const Value evenRe = (re[k] + re[M - k]) * 0.5f;
+            const Value evenIm = (im[k] - im[M - k]) * 0.5f;
+            const Value oddRe = (im[k] + im[M - k]) * 0.5f;
+            const Value oddIm = (re[k] - re[M - k]) * -0.5f;
+
+            d[2 * k] = evenRe + oddRe * splitCos[k] + oddIm * splitSin[k];
+            d[2 * k + 1] = evenIm + oddIm * splitCos[k] - oddRe * splitSin[k];
+        }
+
+        // the upper half is done with, so bins 0 and M can be written now
+        d[0] = dc + dcImag;
+        d[1] = Value();
+        d[size] = dc - dcImag;
+        d[size + 1] = Value();
+
+        if (! onlyCalculateNonNegativeFrequencies)
+            for (int k = M + 1; k < size; ++k) {
+                d[2 * k] = d[2 * (size - k)];
+                d[2 * k + 1] = d[2 * (size - k) + 1] * -1.0f;
+            }
+    }
+
+    template <typename Value>
+    void inverse(Value* d) const noexcept
+    {
+        const int M = complexSize;
+        Value* re = d + size;
+        Value* im = re + M;
+
+        // bin M shares its memory with the split arrays
+        const Value nyquist = d[size];
+
+        // Z[k] = (X[k] + X*[M - k]) + i W^-k (X[k] - X*[M - k]), conjugated for a forward transform
+        // and stored in bit-reversed order
+        for (int k = 0; k < M; ++k) {
+            const Value xRe = d[2 * k];
+            const Value xIm = d[2 * k + 1];
+            const Value mirrorRe = k == 0 ? nyquist : d[2 * (M - k)];
+            const Value mirrorIm = k == 0 ? Value() : d[2 * (M - k) + 1] * -1.0f;
+
+            const Value sumRe = xRe + mirrorRe;
+            const Value sumIm = xIm + mirrorIm;
+            const Value diffRe = xRe - mirrorRe;
+            const Value diffIm = xIm - mirrorIm;
+
+            // W^-k (diff)
+            const Value rotRe = diffRe * splitCos[k] - diffIm * splitSin[k];
+            const Value rotIm = diffIm * splitCos[k] + diffRe * splitSin[k];
+
+            const int target = bitReversed[k];
+            re[target] = sumRe - rotIm;
+            im[target] = (sumIm + rotRe) * -1.0f;
+        }
+
+        performComplexStages(re, im);
+
+        const FloatType scale = (FloatType)1 / (FloatType)size;
+        for (int n = 0; n < M; ++n) {
+            d[2 * n] = re[n] * scale;
+            d[2 * n + 1] = im[n] * -scale;
+        }
+    }
+
+    /**
+     In-place radix-2 decimation-in-time complex FFT of complexSize points on split arrays with
+     bit-reversed input. Templated on the element type so the same butterflies can run on a single
+     transform (FloatType) or on several transforms side by side (one per SIMD lane).
+     */
+    template <typename Value>
+    void performComplexStages(Value* re, Value* im) const noexcept
+    {
+        const int M = complexSize;
+
+        // distance 1: all twiddles are 1
+        for (int a = 0; a + 1 < M; a += 2) {
+            const Value tr = re[a + 1];
+            const Value ti = im[a + 1];
+            re[a + 1] = re[a] - tr;
+            im[a + 1] = im[a] - ti;
+            re[a] = re[a] + tr;
+            im[a] = im[a] + ti;
+        }
+
+        // distance 2: twiddles are 1 and -i
+        for (int b = 0; b + 3 < M; b += 4) {
+            const Value tr0 = re[b + 2];
+            const Value ti0 = im[b + 2];
+            re[b + 2] = re[b] - tr0;
+            im[b + 2] = im[b] - ti0;
+            re[b] = re[b] + tr0;
+            im[b] = im[b] + ti0;
+
+            const Value tr1 = im[b + 3];
+            const Value ti1 = re[b + 3] * -1.0f;
+            re[b + 3] = re[b + 1] - tr1;
+            im[b + 3] = im[b + 1] - ti1;
+            re[b + 1] = re[b + 1] + tr1;
+            im[b + 1] = im[b + 1] + ti1;
+        }
+
+        int h = 4;
+
+        // two stages at once (distances h and 2h) as radix-4 butterflies, halving the passes over memory
+        for (; 4 * h <= M; h *= 4) {
+            const FloatType* __restrict cos1 = stageCos.get() + h;
+            const FloatType* __restrict sin1 = stageSin.get() + h;
+            const FloatType* __restrict cos2 = stageCos.get() + 2 * h;
+            const FloatType* __restrict sin2 = stageSin.get() + 2 * h;
+
+            for (int b = 0; b < M; b += 4 * h) {
+                Value* __restrict re0 = re + b;
+                Value* __restrict im0 = im + b;
+                Value* __restrict re1 = re0 + h;
+                Value* __restrict im1 = im0 + h;
+                Value* __restrict re2 = re1 + h;
+                Value* __restrict im2 = im1 + h;
+                Value* __restrict re3 = re2 + h;
+                Value* __restrict im3 = im2 + h;
+
+                for (int j = 0; j < h; ++j) {
+                    // distance h
+                    const Value t1r = re1[j] * cos1[j] - im1[j] * sin1[j];
+                    const Value t1i = re1[j] * sin1[j] + im1[j] * cos1[j];
+                    const Value t3r = re3[j] * cos1[j] - im3[j] * sin1[j];
+                    const Value t3i = re3[j] * sin1[j] + im3[j] * cos1[j];
+
+                    const Value y0r = re0[j] + t1r;
+                    const Value y0i = im0[j] + t1i;
+                    const Value y1r = re0[j] - t1r;
+                    const Value y1i = im0[j] - t1i;
+                    const Value y2r = re2[j] + t3r;
+                    const Value y2i = im2[j] + t3i;
+                    const Value y3r = re2[j] - t3r;
+                    const Value y3i = im2[j] - t3i;
+
+                    // distance 2h, the twiddle of the second pair is -i times the one of the first
+                    const Value u2r = y2r * cos2[j] - y2i * sin2[j];
+                    const Value u2i = y2r * sin2[j] + y2i * cos2[j];
+                    const Value u3r = y3r * sin2[j] + y3i * cos2[j];
+                    const Value u3i = y3i * sin2[j] - y3r * cos2[j];
+
+                    re0[j] = y0r + u2r;
+                    im0[j] = y0i + u2i;
+                    re2[j] = y0r - u2r;
+                    im2[j] = y0i - u2i;
+                    re1[j] = y1r + u3r;
+                    im1[j] = y1i + u3i;
+                    re3[j] = y1r - u3r;
+                    im3[j] = y1i - u3i;
+                }
+            }
+        }
+
+        // a single remaining stage
+        for (; h < M; h *= 2) {
+            const FloatType* __restrict twCos = stageCos.get() + h;
+            const FloatType* __restrict twSin = stageSin.get() + h;
+
+            for (int b = 0; b < M; b += 2 * h) {
+                Value* __restrict re0 = re + b;
+                Value* __restrict im0 = im + b;
+                Value* __restrict re1 = re + b + h;
+                Value* __restrict im1 = im + b + h;
+
+                for (int j = 0; j < h; ++j) {
+                    const Value tr = re1[j] * twCos[j] - im1[j] * twSin[j];
+                    const Value ti = re1[j] * twSin[j] + im1[j] * twCos[j];
+                    re1[j] = re0[j] - tr;
+                    im1[j] = im0[j] - ti;
+                    re0[j] = re0[j] + tr;
+                    im0[j] = im0[j] + ti;
+                }
+            }
+        }
+    }
+
+    const int size;
+    const int complexSize;
+
+    HeapBlock<int> bitReversed;
+    AlignedArray<FloatType> stageCos;
+    AlignedArray<FloatType> stageSin;
+    AlignedArray<FloatType> splitCos;
+    AlignedArray<FloatType> splitSin;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(SimdRealFft)
+};
@@ -11,23 +11,337 @@
 #pragma once
 
 #include "OverlapAddFftProcessor.h"
+#include "BandGrouping.h"
+
+/**
+ Per-bin compressor/expander. Every bin of every channel has its own envelope follower (in dB, smoothed
+ from frame to frame with attack and release), which drives a soft-knee gain curve:
+ - compressor: levels above the threshold are reduced by the ratio
+ - expander: levels below the threshold are pushed down by the ratio
+ The gain is limited to the range and applied to the bin, followed by the makeup gain.
+
+ With setBandGrouping(), the envelopes and gains are computed for perceptual bands instead, from the
+ summed powers of their bins, and the band gains get interpolated back to the bins. That cuts the
+ dynamics work from fftSize / 2 + 1 evaluations per frame down to the number of bands.
+
+ All per-bin work runs in plain loops without branches or comparisons (abs-based limits and bit-level
+ log2/exp2 approximations), so the compiler can vectorize them over all fftSize / 2 + 1 bins. Those rely on the
+ float bit layout, so the frames and spectra are always float; with double audio, the overlap-add still runs in
+ double (see MixedOverlapAddFftProcessor). processSpectrum() is resolved statically (see OverlapAddFftProcessorBase),
+ so the class is final.
+ */
+template <typename SampleType>
+class BasicSpectralDynamicProcessor final : public OverlapAddFftProcessorBase<BasicSpectralDynamicProcessor<SampleType>, SampleType, float> {
+    using Base = OverlapAddFftProcessorBase<BasicSpectralDynamicProcessor<SampleType>, SampleType, float>;
+    friend Base;
+    using Base::fftSize;
+    using Base::hopSize;
+    using Base::window;
+    using Base::sampleRate;
 
-class SpectralDynamicProcessor : public OverlapAddFftProcessor {
 public:
-    SpectralDynamicProcessor()
-        : OverlapAddFftProcessor(10, 3)
+    using typename Base::SpectrumFormat;
+    using typename Base::SpectrumView;
+    using typename Base::FrameDependency;
+
+    enum class Mode {
+        compressor,
+        expander
+    };
+
+    BasicSpectralDynamicProcessor(const int fftSizeAsPowerOf2 = 10, const int hopSizeDividerAsPowerOf2 = 3)
+        : Base(fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2)
+    {
+        this->setSpectrumFormat(SpectrumFormat::cartesian);
+    }
+    ~BasicSpectralDynamicProcessor()
+    {
+        this->stopFrameWorker();
+    }
+
+    void prepare(const double sampleRate, const int maximumBlockSize, const int numInputChannels, const int numOutputChannels)
+    {
+        Base::prepare(sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+
+        const auto maxCh = jmax(numInputChannels, numOutputChannels);
+        const int numBins = fftSize / 2 + 1;
+
+        envelopes.setSize(maxCh, numBins);
+        gains.setSize(maxCh, numBins);
+        powers.setSize(maxCh, numBins);
+
+        // the grouping only changes here, where its buffers are allocated, as processSpectrum() relies on them
+        bandScale = requestedBandScale.load();
+        bandResolution = requestedBandResolution.load();
+        if (bandScale != BandScale::none) {
+            bandGrouping.create(bandScale, bandResolution, fftSize, sampleRate);
+            bandPowers.setSize(maxCh, bandGrouping.getNumBands());
+            bandGains.setSize(maxCh, bandGrouping.getNumBands());
+        }
+        for (int ch = 0; ch < maxCh; ++ch)
+            FloatVectorOperations::fill(envelopes.getWritePointer(ch), silenceDb, numBins);
+
+        // a full scale sine should read 0 dB: its bin has a magnitude of half the sum of the analysis window
+        float windowSum = 0.0f;
+        for (int n = 0; n < fftSize; ++n)
+            windowSum += window.getAnalysisWindow()[n];
+        levelOffsetDb = -20.0f * std::log10(0.5f * windowSum);
+
+        // the envelopes are the only state across frames, and any difference between two of them shrinks at least
+        // by the slower of attack and release per frame: after enough frames for 120 dB to shrink to about 0.001 dB,
+        // the start is forgotten. Uses the times set at prepare(), longer ones set later aren't covered
+        const auto c = getCoefficients();
+        const auto slowest = jmax(c.attack, c.release);
+        this->setFrameDependency(FrameDependency::warmUp, slowest > 0.0f ? (int)std::ceil(std::log(1.0e-5f) / std::log(slowest)) : 0);
+    }
+
+    /** Clears the buffered audio and the envelopes, can be called from the audio thread */
+    void reset()
     {
+        Base::reset();
+
+        for (int ch = 0; ch < envelopes.getNumChannels(); ++ch)
+            FloatVectorOperations::fill(envelopes.getWritePointer(ch), silenceDb, envelopes.getNumSamples());
+    }
+
+    /** Groups the bins into bands for the dynamics, takes effect with the next call of prepare().
+        Can be called from any thread, the grouping in use stays the same until then
+     @param resolution number of bands, or bands per octave for BandScale::fractionalOctave; 0 for the default
+     */
+    void setBandGrouping(const BandScale newBandScale, const int newResolution = 0)
+    {
+        requestedBandScale.store(newBandScale);
+        requestedBandResolution.store(newResolution);
+    }
+
+    // ====== parameters, can be changed from any thread
+    void setMode(const Mode newMode) { mode.store(newMode); }
+    void setThreshold(const float newThresholdDb) { thresholdDb.store(newThresholdDb); }
+    /** the ratio in dB input / dB output, >= 1 */
+    void setRatio(const float newRatio) { ratio.store(jmax(1.0f, newRatio)); }
+    void setKnee(const float newKneeDb) { kneeDb.store(jmax(0.0f, newKneeDb)); }
+    void setAttack(const float newAttackMs) { attackMs.store(jmax(0.0f, newAttackMs)); }
+    void setRelease(const float newReleaseMs) { releaseMs.store(jmax(0.0f, newReleaseMs)); }
+    /** the maximum gain reduction in dB */
+    void setRange(const float newRangeDb) { rangeDb.store(jmax(0.0f, newRangeDb)); }
+    void setMakeupGain(const float newMakeupDb) { makeupDb.store(newMakeupDb); }
+
+    struct FrameCost {
+        /** average time it takes to process one frame of all channels, including the transforms */
+        double microsecondsPerFrame = 0.0;
+        /** share of one core a single instance takes in real time */
+        double coreLoad = 0.0;
+    };
+
+    /**
+     Measures the cost of a frame by running noise through a new processor in blocks of one hop, to find out how
+     many instances fit on one core. Allocates and takes a moment, so don't call it from the audio thread.
+     */
+    static FrameCost measureFrameCost(const int numChannels, const double sampleRate = 48000.0, const int numFrames = 2000,
+                                      const BandScale bandScale = BandScale::none)
+    {
+        BasicSpectralDynamicProcessor processor;
+        processor.setBandGrouping(bandScale);
+        processor.prepare(sampleRate, processor.hopSize, numChannels, numChannels);
+
+        AudioBuffer<SampleType> block(numChannels, processor.hopSize);
+        Random random(1);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < processor.hopSize; ++n)
+                block.setSample(ch, n, (SampleType)(random.nextFloat() - 0.5f));
+
+        // fill the buffers before timing, so every timed block runs a frame
+        const int numWarmUpFrames = processor.fftSize / processor.hopSize;
+        double seconds = 0.0;
+
+        for (int frame = 0; frame < numWarmUpFrames + numFrames; ++frame) {
+            dsp::AudioBlock<SampleType> audioBlock(block);
+            dsp::ProcessContextReplacing<SampleType> context(audioBlock);
+
+            const auto start = Time::getHighResolutionTicks();
+            processor.process(context);
+            if (frame >= numWarmUpFrames)
+                seconds += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+        }
+
+        FrameCost cost;
+        cost.microsecondsPerFrame = 1.0e6 * seconds / numFrames;
+        cost.coreLoad = cost.microsecondsPerFrame / (1.0e6 * processor.hopSize / sampleRate);
+        return cost;
     }
-    ~SpectralDynamicProcessor() { }
 
 private:
-    void processFrameInBuffer(const int maxNumChannels) override
+    /** Frame-rate coefficients and curve settings, read once per frame from the parameters */
+    struct Coefficients {
+        float attack;
+        float release;
+        float threshold;
+        float halfKnee;
+        float inverseTwoKnee;
+        float compressSlope;
+        float expandSlope;
+        float minGainDb;
+        float makeupDb;
+        float levelOffsetDb;
+    };
+
+    Coefficients getCoefficients() const
+    {
+        const auto framesPerSecond = (float)(sampleRate / hopSize);
+        const auto smoothing = [framesPerSecond](const float ms) { return ms > 0.0f ? std::exp(-1000.0f / (ms * framesPerSecond)) : 0.0f; };
+
+        // a zero knee is a very small one, so the knee term never divides by zero
+        const auto knee = jmax(kneeDb.load(), 1.0e-3f);
+        const auto currentRatio = ratio.load();
+        const auto currentMode = mode.load();
+
+        Coefficients c;
+        c.attack = smoothing(attackMs.load());
+        c.release = smoothing(releaseMs.load());
+        c.threshold = thresholdDb.load();
+        c.halfKnee = 0.5f * knee;
+        c.inverseTwoKnee = 0.5f / knee;
+        c.compressSlope = currentMode == Mode::compressor ? 1.0f / currentRatio - 1.0f : 0.0f;
+        c.expandSlope = currentMode == Mode::expander ? currentRatio - 1.0f : 0.0f;
+        c.minGainDb = -rangeDb.load();
+        c.makeupDb = makeupDb.load();
+        c.levelOffsetDb = levelOffsetDb;
+        return c;
+    }
+
+    void processSpectrum(SpectrumView& spectrum)
+    {
+        const auto c = getCoefficients();
+
+        for (int ch = 0; ch < spectrum.getNumChannels(); ++ch) {
+            const int channel = spectrum.getFirstChannel() + ch;
+
+            float* power = powers.getWritePointer(channel);
+            computePowers(spectrum.getReal(ch), spectrum.getImag(ch), power, spectrum.getNumBins());
+
+            if (bandScale == BandScale::none) {
+                computeGains(power, envelopes.getWritePointer(channel), gains.getWritePointer(channel), spectrum.getNumBins(), c);
+            }
+            else {
+                bandGrouping.sumBins(power, bandPowers.getWritePointer(channel));
+                computeGains(bandPowers.getReadPointer(channel), envelopes.getWritePointer(channel), bandGains.getWritePointer(channel),
+                             bandGrouping.getNumBands(), c);
+                bandGrouping.spreadBands(bandGains.getReadPointer(channel), gains.getWritePointer(channel));
+            }
+
+            FloatVectorOperations::multiply(spectrum.getReal(ch), gains.getReadPointer(channel), spectrum.getNumBins());
+            FloatVectorOperations::multiply(spectrum.getImag(ch), gains.getReadPointer(channel), spectrum.getNumBins());
+        }
+    }
+
+    static void computePowers(const float* __restrict re, const float* __restrict im, float* __restrict power, const int numBins)
+    {
+        for (int k = 0; k < numBins; ++k)
+            power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+
+    /**
+     Level detection, envelope, gain curve and dB to gain for all bins (or bands) of one channel. Every decision is
+     expressed with positivePart() rather than comparisons, as GCC doesn't vectorize float selects unless
+     trapping math is turned off.
+     */
+    static void computeGains(const float* __restrict power, float* __restrict envelope, float* __restrict gain,
+                             const int numBins, const Coefficients c)
+    {
+        // 10 * log10(x) = log2(x) * 10 / log2(10)
+        constexpr float powerToDb = 3.01029996f;
+        // 10^(x / 20) = 2^(x * log2(10) / 20)
+        constexpr float dbToExponent = 0.166096405f;
+
+        const float kneeWidth = 2.0f * c.halfKnee;
+
+        for (int k = 0; k < numBins; ++k) {
+            const float level = fastLog2(power[k] + 1.0e-20f) * powerToDb + c.levelOffsetDb;
+
+            // release towards the level, plus the difference to the attack while it rises
+            const float rise = level - envelope[k];
+            const float env = envelope[k] + (1.0f - c.release) * rise + (c.release - c.attack) * positivePart(rise);
+            envelope[k] = env;
+
+            // soft knee: the quadratic part within the knee plus the linear part beyond it
+            const float over = env - c.threshold;
+            const float overInKnee = positivePart(over + c.halfKnee) - positivePart(over - c.halfKnee);
+            const float overCurve = overInKnee * overInKnee * c.inverseTwoKnee + positivePart(over - c.halfKnee);
+            const float underInKnee = kneeWidth - overInKnee;
+            const float underCurve = underInKnee * underInKnee * c.inverseTwoKnee + positivePart(-over - c.halfKnee);
+
+            // limited to the range
+            const float curveDb = c.compressSlope * overCurve - c.expandSlope * underCurve;
+            const float gainDb = c.minGainDb + positivePart(curveDb - c.minGainDb) + c.makeupDb;
+            gain[k] = fastExp2(gainDb * dbToExponent);
+        }
+    }
+
+    /** max(x, 0) without a comparison */
+    static inline float positivePart(const float x) noexcept
+    {
+        return 0.5f * (x + std::abs(x));
+    }
+
+    /** log2 of a positive, normal float, accurate to about 2e-5 */
+    static inline float fastLog2(const float x) noexcept
+    {
+        int32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const float exponent = (float)((bits >> 23) - 127);
+        bits = (bits & 0x007fffff) | 0x3f800000;
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        // log2(m) = 2 / ln(2) * atanh(t), with t = (m - 1) / (m + 1) within [0, 1/3), as a series in t
+        const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+        const float t2 = t * t;
+        return exponent + t * (2.88539008f + t2 * (0.961796694f + t2 * (0.577078016f + t2 * 0.412198583f)));
+    }
+
+    /** 2^x, accurate to about 1e-4 relative, for x within [-126, 126] */
+    static inline float fastExp2(const float x) noexcept
     {
-        // for (int ch = 0; ch < maxNumChannels; ++ch)
-            // fft.performRealOnlyForwardTransform(fftInOutBuffer.getWritePointer(ch), true);
-        // for (int ch = 0; ch < maxNumChannels; ++ch)
-        //     FloatVectorOperations::clear(fftInOutBuffer.getWritePointer(ch, fftSize / 2), fftSize / 2);
-        // for (int ch = 0; ch < maxNumChannels; ++ch)
-            // fft.performRealOnlyInverseTransform(fftInOutBuffer.getWritePointer(ch));
+        // shifted to be positive, so the truncation is a floor
+        const float lowerLimited = 1.0f + positivePart(x + 126.0f);
+        const float shifted = 253.0f - positivePart(253.0f - lowerLimited);
+        const int32 integer = (int32)shifted;
+        const float fraction = shifted - (float)integer;
+
+        const int32 bits = integer << 23;
+        float power;
+        std::memcpy(&power, &bits, sizeof(power));
+
+        // polynomial fit of 2^x over [0, 1)
+        return power * (1.0f + fraction * (0.6960656421f + fraction * (0.224494337f + fraction * 0.07944023841f)));
     }
+
+    static constexpr float silenceDb = -120.0f;
+
+    AudioBuffer<float> envelopes;
+    AudioBuffer<float> gains;
+    AudioBuffer<float> powers;
+    float levelOffsetDb = 0.0f;
+
+    // the grouping in use, latched from the requested one in prepare()
+    BandScale bandScale = BandScale::none;
+    int bandResolution = 0;
+    std::atomic<BandScale> requestedBandScale { BandScale::none };
+    std::atomic<int> requestedBandResolution { 0 };
+    BandGrouping bandGrouping;
+    AudioBuffer<float> bandPowers;
+    AudioBuffer<float> bandGains;
+
+    std::atomic<Mode> mode { Mode::compressor };
+    std::atomic<float> thresholdDb { -20.0f };
+    std::atomic<float> ratio { 4.0f };
+    std::atomic<float> kneeDb { 6.0f };
+    std::atomic<float> attackMs { 10.0f };
+    std::atomic<float> releaseMs { 100.0f };
+    std::atomic<float> rangeDb { 40.0f };
+    std::atomic<float> makeupDb { 0.0f };
 };
+
+using SpectralDynamicProcessor = BasicSpectralDynamicProcessor<float>;
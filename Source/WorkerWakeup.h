@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    WorkerWakeup.h
+    Created: 21 Oct 2026 10:18:00am
+    Author:  Deddy Welsan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+ #include <semaphore.h>
+ #include <ctime>
+#endif
+
+using namespace juce;
+
+/**
+ Wakes a worker thread from the audio thread without a lock. The worker sleeps on a semaphore, a
+ dispatch semaphore on Apple platforms and a POSIX one elsewhere, so signal() is an atomic increment, plus a
+ futex wake on Linux if the worker is asleep. Thread::notify() would signal a WaitableEvent, which takes a mutex;
+ platforms without one of these semaphores fall back to that.
+
+ Before going to sleep, the worker spins for spinMicroseconds in case the next signal is just about to come.
+ Keep that short: the workers run at real-time priority, and a longer spin takes cores away from the host.
+ Stop the worker with stopWorker(), which wakes it, as it only checks threadShouldExit() when woken, or
+ every maxWaitMilliseconds.
+ */
+class WorkerWakeup {
+public:
+    explicit WorkerWakeup(const int spinMicroseconds = 4)
+        : spinTicks(Time::getHighResolutionTicksPerSecond() * jmax(0, spinMicroseconds) / 1000000)
+    {
+#if JUCE_MAC || JUCE_IOS
+        semaphore = dispatch_semaphore_create(0);
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        sem_init(&semaphore, 0, 0);
+#endif
+    }
+
+    ~WorkerWakeup()
+    {
+#if JUCE_MAC || JUCE_IOS
+        dispatch_release(semaphore);
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        sem_destroy(&semaphore);
+#endif
+    }
+
+    /** Wakes the worker. Can be called from any thread, doesn't lock (see the class description) */
+    void signal() noexcept
+    {
+#if JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_signal(semaphore);
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        sem_post(&semaphore);
+#else
+        event.signal();
+#endif
+    }
+
+    /** Called by the worker: returns true once signalled, or false if the thread should exit */
+    bool waitForSignal(Thread& worker)
+    {
+        while (! worker.threadShouldExit()) {
+            const auto spinEnd = Time::getHighResolutionTicks() + spinTicks;
+            do {
+                if (tryWait())
+                    return ! worker.threadShouldExit();
+            } while (Time::getHighResolutionTicks() < spinEnd);
+
+            if (waitFor(maxWaitMilliseconds))
+                return ! worker.threadShouldExit();
+        }
+
+        return false;
+    }
+
+    /** Stops worker, which waits on this wakeup, without waiting for maxWaitMilliseconds */
+    void stopWorker(Thread& worker, const int timeOutMilliseconds = 1000)
+    {
+        worker.signalThreadShouldExit();
+        signal();
+        worker.stopThread(timeOutMilliseconds);
+    }
+
+    /** The longest a worker sleeps before checking threadShouldExit() again, in case it is stopped without
+        stopWorker() */
+    static constexpr int maxWaitMilliseconds = 50;
+
+private:
+    bool tryWait() noexcept
+    {
+#if JUCE_MAC || JUCE_IOS
+        return dispatch_semaphore_wait(semaphore, DISPATCH_TIME_NOW) == 0;
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        return sem_trywait(&semaphore) == 0;
+#else
+        return event.wait(0);
+#endif
+    }
+
+    bool waitFor(const int milliseconds) noexcept
+    {
+#if JUCE_MAC || JUCE_IOS
+        return dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)milliseconds * 1000000)) == 0;
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        // sem_timedwait() takes an absolute time of the realtime clock
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)milliseconds * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+        return sem_timedwait(&semaphore, &deadline) == 0;
+#else
+        return event.wait(milliseconds);
+#endif
+    }
+
+    const int64 spinTicks;
+
+#if JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_t semaphore;
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+    sem_t semaphore;
+#else
+    WaitableEvent event;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(WorkerWakeup)
+};
+
+/** Starts a worker the audio thread waits for with the priority of an audio thread, or the highest one before
+    JUCE 7.0.3, so it isn't preempted by everything else under load */
+inline void startRealtimeWorker(Thread& worker)
+{
+#if JUCE_VERSION >= 0x070003
+    worker.startRealtimeThread(Thread::RealtimeOptions());
+#else
+    worker.startThread(10);
+#endif
+}
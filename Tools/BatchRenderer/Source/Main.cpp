@@ -0,0 +1,386 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 2:20:00pm
+    Author:  Deddy Welsan
+
+    Headless batch renderer: streams audio files through SpectralDynamicProcessor
+    faster than real time, many files in parallel, or one file on many threads.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/SpectralDynamicProcessor.h"
+#include "../../../Source/OfflineFrameRenderer.h"
+
+//==============================================================================
+/** Everything a render job needs to know, parsed once from the command line */
+struct RenderSettings
+{
+    int fftSizeAsPowerOf2 = 10;
+    int hopSizeDividerAsPowerOf2 = 3;
+    int blockSize = 1 << 16;
+    int numThreads = 1;
+    bool wholeFile = false;
+
+    SpectralDynamicProcessor::Mode mode = SpectralDynamicProcessor::Mode::compressor;
+    float thresholdDb = -20.0f;
+    float ratio = 4.0f;
+    float kneeDb = 6.0f;
+    float attackMs = 10.0f;
+    float releaseMs = 100.0f;
+    float rangeDb = 40.0f;
+    float makeupDb = 0.0f;
+    BandScale bandScale = BandScale::none;
+
+    juce::File outputFolder;
+    bool overwrite = false;
+};
+
+//==============================================================================
+/** Opens a file for reading, memory mapped where the format supports it (WAV, AIFF), streamed otherwise */
+static std::unique_ptr<juce::AudioFormatReader> createReader (juce::AudioFormatManager& formats, const juce::File& file)
+{
+    if (auto* format = formats.findFormatForFileExtension (file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return std::move (mapped);
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+}
+
+static std::unique_ptr<SpectralDynamicProcessor> createProcessor (const RenderSettings& settings)
+{
+    auto processor = std::make_unique<SpectralDynamicProcessor> (settings.fftSizeAsPowerOf2, settings.hopSizeDividerAsPowerOf2);
+    processor->setBandGrouping (settings.bandScale);
+    processor->setMode (settings.mode);
+    processor->setThreshold (settings.thresholdDb);
+    processor->setRatio (settings.ratio);
+    processor->setKnee (settings.kneeDb);
+    processor->setAttack (settings.attackMs);
+    processor->setRelease (settings.releaseMs);
+    processor->setRange (settings.rangeDb);
+    processor->setMakeupGain (settings.makeupDb);
+    return processor;
+}
+
+/**
+ Renders in blocks of settings.blockSize, so the memory doesn't grow with the length of the file. The output is
+ aligned with the input: the latency of the processor is skipped at the start and made up with silence at the end.
+ @returns an error message, or an empty string on success
+ */
+static juce::String renderStreamed (juce::AudioFormatReader& reader, juce::AudioFormatWriter& writer, const RenderSettings& settings)
+{
+    const auto numChannels = (int) reader.numChannels;
+    const auto length = reader.lengthInSamples;
+
+    auto processor = createProcessor (settings);
+    processor->prepare (reader.sampleRate, settings.blockSize, numChannels, numChannels);
+
+    const juce::int64 latency = processor->getLatencySamples();
+    juce::AudioBuffer<float> block (numChannels, settings.blockSize);
+    juce::int64 inputPosition = 0;
+    juce::int64 numWritten = 0;
+
+    while (numWritten < length)
+    {
+        const auto numSamples = (int) juce::jmin ((juce::int64) settings.blockSize, length + latency - inputPosition);
+
+        // the reader fills in silence past the end of the file, which flushes the processor
+        reader.read (&block, 0, numSamples, inputPosition, true, true);
+
+        auto audioBlock = juce::dsp::AudioBlock<float> (block).getSubBlock (0, (size_t) numSamples);
+        processor->process (juce::dsp::ProcessContextReplacing<float> (audioBlock));
+
+        const auto skip = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, latency - inputPosition);
+        const auto numToWrite = (int) juce::jmin ((juce::int64) (numSamples - skip), length - numWritten);
+
+        if (numToWrite > 0 && ! writer.writeFromAudioSampleBuffer (block, skip, numToWrite))
+            return "write error";
+
+        inputPosition += numSamples;
+        numWritten += numToWrite;
+    }
+
+    return {};
+}
+
+/**
+ Renders the whole file at once, with its frames spread over settings.numThreads threads by OfflineFrameRenderer,
+ so a single long file uses all cores. Input and output have to fit into memory.
+ @returns an error message, or an empty string on success
+ */
+static juce::String renderWholeFile (juce::AudioFormatReader& reader, juce::AudioFormatWriter& writer, const RenderSettings& settings)
+{
+    if (reader.lengthInSamples > std::numeric_limits<int>::max())
+        return "too long to render as a whole";
+
+    juce::AudioBuffer<float> input ((int) reader.numChannels, (int) reader.lengthInSamples);
+    reader.read (&input, 0, input.getNumSamples(), 0, true, true);
+
+    juce::AudioBuffer<float> output;
+    OfflineFrameRenderer<SpectralDynamicProcessor> renderer ([&settings] { return createProcessor (settings); }, settings.numThreads);
+    renderer.render (input, output, reader.sampleRate, juce::jmin (settings.blockSize, 8192));
+
+    if (! writer.writeFromAudioSampleBuffer (output, 0, output.getNumSamples()))
+        return "write error";
+
+    return {};
+}
+
+/**
+ Renders one file, streamed or as a whole (settings.wholeFile). The output is written to a temporary file next
+ to the target, which only replaces the target once it is complete.
+ @returns an error message, or an empty string on success
+ */
+static juce::String renderFile (juce::AudioFormatManager& formats, const juce::File& input, const juce::File& output,
+                                const RenderSettings& settings)
+{
+    auto reader = createReader (formats, input);
+    if (reader == nullptr)
+        return "can't read " + input.getFullPathName();
+
+    auto* format = formats.findFormatForFileExtension (output.getFileExtension());
+    if (format == nullptr)
+        return "no format to write " + output.getFileName();
+
+    const auto numChannels = (int) reader->numChannels;
+
+    // keep the bit depth of the input where the output format supports it
+    auto bitsPerSample = (int) reader->bitsPerSample;
+    if (! format->getPossibleBitDepths().contains (bitsPerSample))
+        bitsPerSample = format->getPossibleBitDepths().getLast();
+
+    juce::TemporaryFile temporary (output);
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    {
+        auto stream = std::make_unique<juce::FileOutputStream> (temporary.getFile());
+        if (stream->failedToOpen())
+            return "can't write " + output.getFullPathName();
+
+        writer.reset (format->createWriterFor (stream.get(), reader->sampleRate, (unsigned int) numChannels,
+                                               bitsPerSample, reader->metadataValues, 0));
+        if (writer == nullptr)
+            return "can't write " + output.getFileName() + " with " + juce::String (numChannels) + " channels";
+
+        // the writer owns the stream now
+        stream.release();
+    }
+
+    const auto error = settings.wholeFile ? renderWholeFile (*reader, *writer, settings)
+                                          : renderStreamed (*reader, *writer, settings);
+    if (error.isNotEmpty())
+        return error + " in " + output.getFileName();
+
+    // flush and close the file before it's moved into place
+    writer.reset();
+
+    if (! temporary.overwriteTargetFileWithTemporary())
+        return "can't replace " + output.getFullPathName();
+
+    return {};
+}
+
+//==============================================================================
+/** An audio file to render, and where its output goes */
+struct RenderJob
+{
+    juce::File input;
+    juce::File output;
+};
+
+/**
+ Adds the audio files given on the command line, searching folders recursively. A file found in a folder keeps
+ its path relative to that folder below the output folder, so files of the same name in different subfolders
+ don't end up in the same output file.
+ */
+static void collectInputFiles (const juce::ArgumentList& args, juce::AudioFormatManager& formats, const RenderSettings& settings,
+                               juce::Array<RenderJob>& jobs)
+{
+    const auto wildcards = formats.getWildcardForAllFormats();
+
+    for (auto& argument : args.arguments)
+    {
+        const auto file = argument.resolveAsFile();
+
+        if (file.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator (file, true, wildcards, juce::File::findFiles))
+                jobs.add ({ entry.getFile(), settings.outputFolder.getChildFile (entry.getFile().getRelativePathFrom (file)) });
+        }
+        else if (file.existsAsFile())
+        {
+            jobs.add ({ file, settings.outputFolder.getChildFile (file.getFileName()) });
+        }
+        else
+        {
+            juce::ConsoleApplication::fail ("No such file or folder: " + argument.text);
+        }
+    }
+
+    // the same output can still come from several arguments, e.g. two files of the same name. The jobs would
+    // write it at the same time, so refuse to start
+    std::map<juce::String, juce::File> inputOfOutput;
+    for (const auto& job : jobs)
+    {
+        auto path = job.output.getFullPathName();
+        if (! juce::File::areFileNamesCaseSensitive())
+            path = path.toLowerCase();
+
+        const auto inserted = inputOfOutput.emplace (path, job.input);
+        if (! inserted.second)
+            juce::ConsoleApplication::fail ("Both " + inserted.first->second.getFullPathName() + " and " + job.input.getFullPathName()
+                                            + " would be rendered to " + job.output.getFullPathName());
+    }
+}
+
+static float parseFloatOption (juce::ArgumentList& args, juce::StringRef option, const float defaultValue)
+{
+    const auto value = args.removeValueForOption (option);
+    return value.isEmpty() ? defaultValue : value.getFloatValue();
+}
+
+static int parseIntOption (juce::ArgumentList& args, juce::StringRef option, const int defaultValue)
+{
+    const auto value = args.removeValueForOption (option);
+    return value.isEmpty() ? defaultValue : value.getIntValue();
+}
+
+static RenderSettings parseSettings (juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    settings.fftSizeAsPowerOf2 = juce::jlimit (6, 15, parseIntOption (args, "--fft-order", settings.fftSizeAsPowerOf2));
+    settings.hopSizeDividerAsPowerOf2 = juce::jlimit (1, settings.fftSizeAsPowerOf2, parseIntOption (args, "--hop-divider", settings.hopSizeDividerAsPowerOf2));
+    settings.blockSize = juce::jmax (1, parseIntOption (args, "--block-size", settings.blockSize));
+    settings.numThreads = juce::jmax (1, parseIntOption (args, "--threads", juce::SystemStats::getNumCpus()));
+    settings.wholeFile = args.removeOptionIfFound ("--whole-file");
+
+    if (args.removeValueForOption ("--mode") == "expander")
+        settings.mode = SpectralDynamicProcessor::Mode::expander;
+
+    settings.thresholdDb = parseFloatOption (args, "--threshold", settings.thresholdDb);
+    settings.ratio = parseFloatOption (args, "--ratio", settings.ratio);
+    settings.kneeDb = parseFloatOption (args, "--knee", settings.kneeDb);
+    settings.attackMs = parseFloatOption (args, "--attack", settings.attackMs);
+    settings.releaseMs = parseFloatOption (args, "--release", settings.releaseMs);
+    settings.rangeDb = parseFloatOption (args, "--range", settings.rangeDb);
+    settings.makeupDb = parseFloatOption (args, "--makeup", settings.makeupDb);
+
+    const auto bands = args.removeValueForOption ("--bands");
+    if (bands == "bark")                settings.bandScale = BandScale::bark;
+    else if (bands == "erb")            settings.bandScale = BandScale::erb;
+    else if (bands == "octave")         settings.bandScale = BandScale::fractionalOctave;
+    else if (bands.isNotEmpty() && bands != "none")
+        juce::ConsoleApplication::fail ("Unknown band scale: " + bands);
+
+    const auto outputFolder = args.removeValueForOption ("-o|--output");
+    if (outputFolder.isEmpty())
+        juce::ConsoleApplication::fail ("No output folder, use --output <folder>");
+
+    settings.outputFolder = juce::File::getCurrentWorkingDirectory().getChildFile (outputFolder.unquoted());
+    settings.overwrite = args.removeOptionIfFound ("--overwrite");
+    return settings;
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: BatchRenderer [options] --output <folder> <files or folders...>" << std::endl
+              << std::endl
+              << "Renders WAV, AIFF and FLAC files through the spectral dynamics processor. The output keeps" << std::endl
+              << "the name, format, channel count and (where possible) bit depth of the input. Files found in" << std::endl
+              << "a folder keep their path below it in the output folder." << std::endl
+              << std::endl
+              << "  --threads <n>        threads to render on (default: number of cores)" << std::endl
+              << "  --whole-file         render one file after the other, each on all threads at once, instead of" << std::endl
+              << "                       one file per thread. Faster for a few long files, needs them in memory" << std::endl
+              << "  --block-size <n>     samples per processing block (default 65536)" << std::endl
+              << "  --fft-order <n>      fftSize = 2^n (default 10)" << std::endl
+              << "  --hop-divider <n>    hopSize = fftSize / 2^n (default 3)" << std::endl
+              << "  --mode <m>           compressor or expander" << std::endl
+              << "  --threshold <dB>  --ratio <r>  --knee <dB>  --attack <ms>  --release <ms>" << std::endl
+              << "  --range <dB>  --makeup <dB>" << std::endl
+              << "  --bands <scale>      none, bark, erb or octave" << std::endl
+              << "  --overwrite          replace existing output files" << std::endl;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.size() == 0 || args.containsOption ("-h|--help"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    return juce::ConsoleApplication::invokeCatchingFailures ([&args]
+    {
+        const auto settings = parseSettings (args);
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        juce::Array<RenderJob> jobs;
+        collectInputFiles (args, formats, settings, jobs);
+
+        if (jobs.isEmpty())
+            juce::ConsoleApplication::fail ("No input files");
+
+        // the folders are created up front, jobs creating the same one at the same time could fail
+        for (const auto& job : jobs)
+            if (! job.output.getParentDirectory().createDirectory())
+                juce::ConsoleApplication::fail ("Can't create " + job.output.getParentDirectory().getFullPathName());
+
+        // one job per file, each with its own processor, so the files run in parallel without sharing any state.
+        // A whole file render uses all threads by itself, so those run one after the other
+        juce::CriticalSection consoleLock;
+        std::atomic<int> numFailed { 0 };
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        {
+            juce::ThreadPool pool (settings.wholeFile ? 1 : settings.numThreads);
+
+            for (const auto& job : jobs)
+            {
+                pool.addJob ([&formats, &settings, &consoleLock, &numFailed, input = job.input, output = job.output]
+                {
+                    juce::String error;
+
+                    if (output == input)
+                        error = "output would overwrite the input";
+                    else if (output.exists() && ! settings.overwrite)
+                        error = "exists, use --overwrite to replace it";
+                    else
+                        error = renderFile (formats, input, output, settings);
+
+                    const juce::ScopedLock lock (consoleLock);
+
+                    if (error.isEmpty())
+                    {
+                        std::cout << "done   " << output.getRelativePathFrom (settings.outputFolder) << std::endl;
+                    }
+                    else
+                    {
+                        std::cerr << "failed " << output.getRelativePathFrom (settings.outputFolder) << ": " << error << std::endl;
+                        ++numFailed;
+                    }
+                });
+            }
+
+            while (pool.getNumJobs() > 0)
+                juce::Thread::sleep (50);
+        }
+
+        std::cout << jobs.size() - numFailed.load() << " of " << jobs.size() << " files rendered in "
+                  << juce::String ((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 1) << " s" << std::endl;
+
+        return numFailed.load() > 0 ? 1 : 0;
+    });
+}
@@ -0,0 +1,595 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 8:05:00pm
+    Author:  Deddy Welsan
+
+    Benchmark: measures what the FFT processors cost per sample and per host
+    callback over a sweep of FFT sizes, hops, channel counts and block sizes,
+    and writes a JSON report to compare between versions.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/OverlapAddFftProcessor.h"
+#include "../../../Source/OverlappingFftProcessor.h"
+#include "../../../Source/FixedOverlapAddFftProcessor.h"
+#include "../../../Source/SpectralDynamicProcessor.h"
+#include "../../../Source/ReconfigurableFftProcessor.h"
+#include "../../../Source/MultiResolutionFftProcessor.h"
+
+//==============================================================================
+/** The processors behind one interface, so the sweep doesn't depend on their types */
+class ProcessorUnderTest
+{
+public:
+    virtual ~ProcessorUnderTest() = default;
+    virtual void prepare (double sampleRate, int blockSize, int numChannels) = 0;
+    virtual void process (juce::dsp::AudioBlock<float>& block) = 0;
+};
+
+template <typename ProcessorType>
+class ProcessorAdapter : public ProcessorUnderTest
+{
+public:
+    explicit ProcessorAdapter (std::unique_ptr<ProcessorType> processorToUse)
+        : processor (std::move (processorToUse))
+    {
+    }
+
+    void prepare (double sampleRate, int blockSize, int numChannels) override
+    {
+        processor->prepare (sampleRate, blockSize, numChannels, numChannels);
+    }
+
+    void process (juce::dsp::AudioBlock<float>& block) override
+    {
+        processor->process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+
+private:
+    std::unique_ptr<ProcessorType> processor;
+};
+
+template <typename ProcessorType>
+static std::unique_ptr<ProcessorUnderTest> adapt (std::unique_ptr<ProcessorType> processor)
+{
+    return std::make_unique<ProcessorAdapter<ProcessorType>> (std::move (processor));
+}
+
+//==============================================================================
+// The pipelines are measured with a forward and an inverse transform per frame and channel, the least any
+// spectral processor does, so the numbers show the cost of the buffering and the transforms
+
+class RoundTripOverlapAddProcessor : public OverlapAddFftProcessor
+{
+public:
+    RoundTripOverlapAddProcessor (int fftSizeAsPowerOf2, int hopSizeDividerAsPowerOf2)
+        : OverlapAddFftProcessor (fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2)
+    {
+    }
+
+private:
+    void processChannelFrame (const int ch) override
+    {
+        fft.performRealOnlyForwardTransform (fftInOutBuffer.getWritePointer (ch), true);
+        fft.performRealOnlyInverseTransform (fftInOutBuffer.getWritePointer (ch));
+    }
+};
+
+class RoundTripOverlappingProcessor final : public OverlappingFFTProcessorBase<RoundTripOverlappingProcessor, float>
+{
+public:
+    RoundTripOverlappingProcessor (int fftSizeAsPowerOf2, int hopSizeDividerAsPowerOf2)
+        : OverlappingFFTProcessorBase (fftSizeAsPowerOf2, hopSizeDividerAsPowerOf2)
+    {
+    }
+
+private:
+    friend OverlappingFFTProcessorBase;
+
+    void processChannelFrame (const int ch)
+    {
+        fft.performRealOnlyForwardTransform (fftInOutBuffer.getWritePointer (ch), true);
+        fft.performRealOnlyInverseTransform (fftInOutBuffer.getWritePointer (ch));
+    }
+};
+
+/** The most channels the compile-time sized processors are built for */
+static constexpr int maxFixedChannels = 8;
+
+template <int FftOrder, int HopDivider>
+class RoundTripFixedProcessor final
+    : public FixedOverlapAddFftProcessorBase<RoundTripFixedProcessor<FftOrder, HopDivider>, FftOrder, HopDivider, maxFixedChannels>
+{
+private:
+    using Base = FixedOverlapAddFftProcessorBase<RoundTripFixedProcessor<FftOrder, HopDivider>, FftOrder, HopDivider, maxFixedChannels>;
+    friend Base;
+
+    void processChannelFrame (const int ch)
+    {
+        this->fft.performRealOnlyForwardTransform (this->fftInOutBuffer[(size_t) ch].data(), true);
+        this->fft.performRealOnlyInverseTransform (this->fftInOutBuffer[(size_t) ch].data());
+    }
+};
+
+/** Walks through the configurations FixedOverlapAddFftProcessor is instantiated for: orders 8 to 15, dividers 1 to 4 */
+template <int FftOrder, int HopDivider>
+struct FixedProcessorFactory
+{
+    static std::unique_ptr<ProcessorUnderTest> create (int fftOrder, int hopDivider)
+    {
+        if (fftOrder == FftOrder && hopDivider == HopDivider)
+            return adapt (std::make_unique<RoundTripFixedProcessor<FftOrder, HopDivider>>());
+
+        return FixedProcessorFactory<HopDivider == 4 ? FftOrder + 1 : FftOrder, HopDivider == 4 ? 1 : HopDivider + 1>::create (fftOrder, hopDivider);
+    }
+};
+
+template <>
+struct FixedProcessorFactory<16, 1>
+{
+    static std::unique_ptr<ProcessorUnderTest> create (int, int) { return nullptr; }
+};
+
+//==============================================================================
+/** One point of the sweep */
+struct BenchmarkCase
+{
+    juce::String processorName;
+    int fftOrder = 10;
+    int hopDivider = 2;
+    int numChannels = 2;
+    int blockSize = 512;
+
+    juce::String getName() const
+    {
+        return processorName + "/fft:" + juce::String (1 << fftOrder) + "/hop:" + juce::String ((1 << fftOrder) >> hopDivider)
+                 + "/ch:" + juce::String (numChannels) + "/block:" + juce::String (blockSize);
+    }
+};
+
+struct BenchmarkResult
+{
+    BenchmarkCase benchmarkCase;
+    juce::int64 numSamples = 0;
+    int numCallbacks = 0;
+    double nanosecondsPerSample = 0.0;
+    double framesPerSecond = 0.0;
+    double p50Microseconds = 0.0;
+    double p99Microseconds = 0.0;
+    double maxMicroseconds = 0.0;
+};
+
+static std::unique_ptr<ProcessorUnderTest> createProcessor (const BenchmarkCase& c)
+{
+    if (c.processorName == "OverlapAddFftProcessor")
+        return adapt (std::make_unique<RoundTripOverlapAddProcessor> (c.fftOrder, c.hopDivider));
+
+    if (c.processorName == "OverlappingFFTProcessor")
+        return adapt (std::make_unique<RoundTripOverlappingProcessor> (c.fftOrder, c.hopDivider));
+
+    if (c.processorName == "FixedOverlapAddFftProcessor")
+        return c.numChannels <= maxFixedChannels ? FixedProcessorFactory<8, 1>::create (c.fftOrder, c.hopDivider) : nullptr;
+
+    if (c.processorName == "SpectralDynamicProcessor")
+        return adapt (std::make_unique<SpectralDynamicProcessor> (c.fftOrder, c.hopDivider));
+
+    return nullptr;
+}
+
+static const juce::StringArray processorNames { "OverlapAddFftProcessor", "OverlappingFFTProcessor",
+                                                "FixedOverlapAddFftProcessor", "SpectralDynamicProcessor" };
+
+//==============================================================================
+static double ticksToMicroseconds (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+}
+
+/** The value below which the given fraction of the sorted values lies */
+static double percentile (const std::vector<juce::int64>& sortedTicks, double fraction)
+{
+    const auto index = juce::jlimit ((size_t) 0, sortedTicks.size() - 1, (size_t) (fraction * (double) sortedTicks.size()));
+    return ticksToMicroseconds (sortedTicks[index]);
+}
+
+/**
+ Feeds noise through the processor in callbacks of c.blockSize samples, as a host would, and times every callback.
+ The first fftSize samples and at least a quarter of a second are a warm-up that isn't measured, so the caches
+ and the branch predictors are in their steady state. Then seconds of audio are measured, but at least 16 frames
+ and 64 callbacks, so the percentiles have something to go on.
+ */
+static bool runCase (const BenchmarkCase& c, double sampleRate, double seconds, BenchmarkResult& result)
+{
+    auto processor = createProcessor (c);
+    if (processor == nullptr)
+        return false;
+
+    processor->prepare (sampleRate, c.blockSize, c.numChannels);
+
+    const int fftSize = 1 << c.fftOrder;
+    const int hopSize = fftSize >> c.hopDivider;
+
+    juce::AudioBuffer<float> noise (c.numChannels, c.blockSize);
+    juce::AudioBuffer<float> buffer (c.numChannels, c.blockSize);
+    juce::Random random (c.fftOrder * 1000 + c.numChannels);
+
+    for (int ch = 0; ch < c.numChannels; ++ch)
+        for (int i = 0; i < c.blockSize; ++i)
+            noise.setSample (ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+    const auto numWarmUpSamples = juce::jmax ((juce::int64) fftSize, (juce::int64) (0.25 * sampleRate));
+    const auto numMeasuredSamples = juce::jmax ((juce::int64) (16 * fftSize), (juce::int64) (seconds * sampleRate));
+    const auto numWarmUpCallbacks = (int) ((numWarmUpSamples + c.blockSize - 1) / c.blockSize);
+    const auto numCallbacks = juce::jmax (64, (int) ((numMeasuredSamples + c.blockSize - 1) / c.blockSize));
+
+    std::vector<juce::int64> callbackTicks ((size_t) numCallbacks);
+    juce::int64 totalTicks = 0;
+
+    for (int callback = -numWarmUpCallbacks; callback < numCallbacks; ++callback)
+    {
+        // the input is restored outside of the timed part, a replacing process overwrites it
+        for (int ch = 0; ch < c.numChannels; ++ch)
+            buffer.copyFrom (ch, 0, noise, ch, 0, c.blockSize);
+
+        juce::dsp::AudioBlock<float> block (buffer);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor->process (block);
+        const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+        if (callback >= 0)
+        {
+            callbackTicks[(size_t) callback] = ticks;
+            totalTicks += ticks;
+        }
+    }
+
+    std::sort (callbackTicks.begin(), callbackTicks.end());
+
+    const auto totalSeconds = juce::jmax (1.0e-9, juce::Time::highResolutionTicksToSeconds (totalTicks));
+    const auto numSamples = (juce::int64) numCallbacks * c.blockSize;
+
+    result.benchmarkCase = c;
+    result.numSamples = numSamples;
+    result.numCallbacks = numCallbacks;
+    result.nanosecondsPerSample = totalSeconds * 1.0e9 / ((double) numSamples * c.numChannels);
+    result.framesPerSecond = (double) (numSamples / hopSize) / totalSeconds;
+    result.p50Microseconds = percentile (callbackTicks, 0.5);
+    result.p99Microseconds = percentile (callbackTicks, 0.99);
+    result.maxMicroseconds = ticksToMicroseconds (callbackTicks.back());
+    return true;
+}
+
+/**
+ The micro benchmark under all processors: one forward and one inverse real-only transform of the FftBackend,
+ timed per pair. Reported like a processor case with one channel and a block of one frame.
+ */
+static BenchmarkResult runTransformCase (int fftOrder, double seconds)
+{
+    const int fftSize = 1 << fftOrder;
+    FftBackend<float> fft (fftOrder);
+
+    juce::HeapBlock<float> frame ((size_t) (2 * fftSize), true);
+    juce::Random random (fftOrder);
+
+    for (int i = 0; i < fftSize; ++i)
+        frame[i] = random.nextFloat() * 0.5f - 0.25f;
+
+    const auto numPairs = juce::jmax (64, (int) (seconds * 48000.0 / fftSize) * 4);
+
+    std::vector<juce::int64> pairTicks ((size_t) numPairs);
+    juce::int64 totalTicks = 0;
+
+    for (int pair = -16; pair < numPairs; ++pair)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        fft.performRealOnlyForwardTransform (frame.get(), true);
+        fft.performRealOnlyInverseTransform (frame.get());
+        const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+        if (pair >= 0)
+        {
+            pairTicks[(size_t) pair] = ticks;
+            totalTicks += ticks;
+        }
+    }
+
+    std::sort (pairTicks.begin(), pairTicks.end());
+
+    const auto totalSeconds = juce::jmax (1.0e-9, juce::Time::highResolutionTicksToSeconds (totalTicks));
+
+    BenchmarkResult result;
+    result.benchmarkCase = { "FftBackend", fftOrder, 0, 1, fftSize };
+    result.numSamples = (juce::int64) numPairs * fftSize;
+    result.numCallbacks = numPairs;
+    result.nanosecondsPerSample = totalSeconds * 1.0e9 / (double) result.numSamples;
+    result.framesPerSecond = numPairs / totalSeconds;
+    result.p50Microseconds = percentile (pairTicks, 0.5);
+    result.p99Microseconds = percentile (pairTicks, 0.99);
+    result.maxMicroseconds = ticksToMicroseconds (pairTicks.back());
+    return result;
+}
+
+//==============================================================================
+/** The sweep, parsed from the command line */
+struct BenchmarkSettings
+{
+    juce::Array<int> fftOrders { 8, 9, 10, 11, 12, 13, 14, 15 };
+    juce::Array<int> hopDividers { 1, 2, 3 };
+    juce::Array<int> channelCounts { 1, 2, 8 };
+    juce::Array<int> blockSizes { 1, 64, 441, 512, 4096 };
+    juce::StringArray filters;
+    double sampleRate = 48000.0;
+    double seconds = 0.5;
+    juce::File jsonFile;
+};
+
+/** Parses "8,10,12" or a range "8-15" */
+static juce::Array<int> parseIntList (juce::ArgumentList& args, juce::StringRef option, const juce::Array<int>& defaultValues)
+{
+    const auto value = args.removeValueForOption (option);
+    if (value.isEmpty())
+        return defaultValues;
+
+    juce::Array<int> values;
+
+    for (auto& item : juce::StringArray::fromTokens (value, ",", ""))
+    {
+        if (item.containsChar ('-'))
+        {
+            for (int v = item.upToFirstOccurrenceOf ("-", false, false).getIntValue(); v <= item.fromFirstOccurrenceOf ("-", false, false).getIntValue(); ++v)
+                values.add (v);
+        }
+        else
+        {
+            values.add (item.getIntValue());
+        }
+    }
+
+    if (values.isEmpty())
+        juce::ConsoleApplication::fail ("Invalid list for " + juce::String (option) + ": " + value);
+
+    return values;
+}
+
+static BenchmarkSettings parseSettings (juce::ArgumentList& args)
+{
+    BenchmarkSettings settings;
+
+    settings.fftOrders = parseIntList (args, "--fft-orders", settings.fftOrders);
+    settings.hopDividers = parseIntList (args, "--hop-dividers", settings.hopDividers);
+    settings.channelCounts = parseIntList (args, "--channels", settings.channelCounts);
+    settings.blockSizes = parseIntList (args, "--block-sizes", settings.blockSizes);
+
+    for (auto order : settings.fftOrders)
+        if (order < 8 || order > 15)
+            juce::ConsoleApplication::fail ("FFT orders go from 8 to 15");
+
+    for (auto value : settings.channelCounts)
+        if (value < 1)
+            juce::ConsoleApplication::fail ("Channel counts start at 1");
+
+    for (auto value : settings.blockSizes)
+        if (value < 1)
+            juce::ConsoleApplication::fail ("Block sizes start at 1");
+
+    settings.filters = juce::StringArray::fromTokens (args.removeValueForOption ("--filter"), ",", "");
+    settings.filters.removeEmptyStrings();
+
+    const auto seconds = args.removeValueForOption ("--seconds");
+    if (seconds.isNotEmpty())
+        settings.seconds = juce::jmax (0.001, seconds.getDoubleValue());
+
+    const auto jsonFile = args.removeValueForOption ("--json");
+    if (jsonFile.isNotEmpty())
+        settings.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (jsonFile.unquoted());
+
+    return settings;
+}
+
+/** A case runs if its name contains any of the filters, or if there are none */
+static bool matchesFilters (const juce::String& name, const juce::StringArray& filters)
+{
+    if (filters.isEmpty())
+        return true;
+
+    for (auto& filter : filters)
+        if (name.contains (filter))
+            return true;
+
+    return false;
+}
+
+#include "Verification.h"
+
+static VerificationSettings parseVerificationSettings (juce::ArgumentList& args)
+{
+    VerificationSettings settings;
+
+    settings.fftOrders = parseIntList (args, "--fft-orders", settings.fftOrders);
+    settings.hopDividers = parseIntList (args, "--hop-dividers", settings.hopDividers);
+    settings.channelCounts = parseIntList (args, "--channels", settings.channelCounts);
+    settings.blockSizes = parseIntList (args, "--block-sizes", settings.blockSizes);
+    settings.requireBitExact = args.removeOptionIfFound ("--bit-exact");
+
+    for (auto order : settings.fftOrders)
+        if (order < 6 || order > 15)
+            juce::ConsoleApplication::fail ("FFT orders go from 6 to 15");
+
+    for (auto value : settings.channelCounts)
+        if (value < 1)
+            juce::ConsoleApplication::fail ("Channel counts start at 1");
+
+    for (auto value : settings.blockSizes)
+        if (value < 1)
+            juce::ConsoleApplication::fail ("Block sizes start at 1");
+
+    settings.filters = juce::StringArray::fromTokens (args.removeValueForOption ("--filter"), ",", "");
+    settings.filters.removeEmptyStrings();
+    return settings;
+}
+
+//==============================================================================
+static juce::var toJson (const BenchmarkResult& result)
+{
+    const auto& c = result.benchmarkCase;
+    auto* object = new juce::DynamicObject();
+
+    object->setProperty ("name", c.getName());
+    object->setProperty ("processor", c.processorName);
+    object->setProperty ("fft_size", 1 << c.fftOrder);
+    object->setProperty ("hop_size", (1 << c.fftOrder) >> c.hopDivider);
+    object->setProperty ("channels", c.numChannels);
+    object->setProperty ("block_size", c.blockSize);
+    object->setProperty ("samples", result.numSamples);
+    object->setProperty ("callbacks", result.numCallbacks);
+    object->setProperty ("ns_per_sample", result.nanosecondsPerSample);
+    object->setProperty ("frames_per_second", result.framesPerSecond);
+    object->setProperty ("callback_p50_us", result.p50Microseconds);
+    object->setProperty ("callback_p99_us", result.p99Microseconds);
+    object->setProperty ("callback_max_us", result.maxMicroseconds);
+    return juce::var (object);
+}
+
+/** The machine and build the results belong to, results of different contexts don't compare */
+static juce::var createContext (const BenchmarkSettings& settings)
+{
+    auto* object = new juce::DynamicObject();
+
+    object->setProperty ("date", juce::Time::getCurrentTime().toISO8601 (true));
+    object->setProperty ("host_name", juce::SystemStats::getComputerName());
+    object->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    object->setProperty ("num_cpus", juce::SystemStats::getNumCpus());
+    object->setProperty ("juce_version", juce::SystemStats::getJUCEVersion());
+   #if JUCE_DEBUG
+    object->setProperty ("build_type", "debug");
+   #else
+    object->setProperty ("build_type", "release");
+   #endif
+    object->setProperty ("fft_backend", (int) OVERLAP_ADD_FFT_BACKEND);
+    object->setProperty ("sample_rate", settings.sampleRate);
+    object->setProperty ("measured_seconds", settings.seconds);
+    return juce::var (object);
+}
+
+static void printResult (const BenchmarkResult& result)
+{
+    std::cout << result.benchmarkCase.getName().paddedRight (' ', 64)
+              << juce::String (result.nanosecondsPerSample, 2).paddedLeft (' ', 10) << " ns/sample"
+              << juce::String (result.framesPerSecond, 0).paddedLeft (' ', 12) << " frames/s"
+              << juce::String (result.p50Microseconds, 2).paddedLeft (' ', 11)
+              << juce::String (result.p99Microseconds, 2).paddedLeft (' ', 11)
+              << juce::String (result.maxMicroseconds, 2).paddedLeft (' ', 11) << " us" << std::endl;
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: Benchmark [options]" << std::endl
+              << std::endl
+              << "Measures the FFT processors with a forward and inverse transform per frame, and the spectral" << std::endl
+              << "dynamics processor, over every combination of the lists below. ns/sample is per sample of one" << std::endl
+              << "channel, frames/s counts hops, and the callback times are the p50, p99 and max of the host blocks." << std::endl
+              << "Lists are comma separated values or ranges, e.g. 8-15 or 1,64,441." << std::endl
+              << std::endl
+              << "  --fft-orders <list>    fftSize = 2^n, 8 to 15 (default 8-15)" << std::endl
+              << "  --hop-dividers <list>  hopSize = fftSize / 2^n (default 1-3)" << std::endl
+              << "  --channels <list>      (default 1,2,8)" << std::endl
+              << "  --block-sizes <list>   samples per callback (default 1,64,441,512,4096)" << std::endl
+              << "  --filter <texts>       only the cases whose name contains one of the comma separated texts" << std::endl
+              << "  --seconds <s>          audio measured per case (default 0.5)" << std::endl
+              << "  --json <file>          writes the results as JSON, to diff between versions" << std::endl
+              << std::endl
+              << "Usage: Benchmark --verify [options]" << std::endl
+              << std::endl
+              << "Checks every processor variant with identity, zero and random gain frames against a plain" << std::endl
+              << "overlap-add reference: reconstruction error, latency, block size independence and crosstalk" << std::endl
+              << "between channels. Exits with 1 if a case fails. Takes the lists and --filter from above, with" << std::endl
+              << "the defaults --fft-orders 8,10 --hop-dividers 1-3 --channels 1,2,5 --block-sizes 1,7,64,441,512,4096." << std::endl
+              << std::endl
+              << "  --bit-exact            also fails cases whose output changes with the block size at all" << std::endl;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("-h|--help"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    return juce::ConsoleApplication::invokeCatchingFailures ([&args]
+    {
+        if (args.removeOptionIfFound ("--verify"))
+        {
+            const auto settings = parseVerificationSettings (args);
+
+            if (args.size() > 0)
+                juce::ConsoleApplication::fail ("Unknown option: " + args[0].text);
+
+            return runVerification (settings) > 0 ? 1 : 0;
+        }
+
+        const auto settings = parseSettings (args);
+
+        if (args.size() > 0)
+            juce::ConsoleApplication::fail ("Unknown option: " + args[0].text);
+
+        juce::Array<juce::var> results;
+
+        std::cout << juce::String ("case").paddedRight (' ', 64) << juce::String ("cost").paddedLeft (' ', 20)
+                  << juce::String ("throughput").paddedLeft (' ', 21) << juce::String ("p50").paddedLeft (' ', 11)
+                  << juce::String ("p99").paddedLeft (' ', 11) << juce::String ("max").paddedLeft (' ', 11) << std::endl;
+
+        for (auto order : settings.fftOrders)
+        {
+            if (! matchesFilters (BenchmarkCase { "FftBackend", order, 0, 1, 1 << order }.getName(), settings.filters))
+                continue;
+
+            const auto result = runTransformCase (order, settings.seconds);
+            printResult (result);
+            results.add (toJson (result));
+        }
+
+        for (auto& processorName : processorNames)
+            for (auto order : settings.fftOrders)
+                for (auto hopDivider : settings.hopDividers)
+                    for (auto numChannels : settings.channelCounts)
+                        for (auto blockSize : settings.blockSizes)
+                        {
+                            if (hopDivider < 1 || hopDivider > order)
+                                continue;
+
+                            const BenchmarkCase c { processorName, order, hopDivider, numChannels, blockSize };
+                            if (! matchesFilters (c.getName(), settings.filters))
+                                continue;
+
+                            BenchmarkResult result;
+                            if (! runCase (c, settings.sampleRate, settings.seconds, result))
+                                continue;
+
+                            printResult (result);
+                            results.add (toJson (result));
+                        }
+
+        if (settings.jsonFile != juce::File())
+        {
+            auto* report = new juce::DynamicObject();
+            report->setProperty ("context", createContext (settings));
+            report->setProperty ("benchmarks", results);
+
+            if (! settings.jsonFile.replaceWithText (juce::JSON::toString (juce::var (report))))
+                juce::ConsoleApplication::fail ("Can't write " + settings.jsonFile.getFullPathName());
+
+            std::cout << "Results written to " << settings.jsonFile.getFullPathName() << std::endl;
+        }
+
+        return 0;
+    });
+}
@@ -0,0 +1,787 @@
+/*
+  ==============================================================================
+
+    Verification.h
+    Created: 20 Oct 2026 10:30:00am
+    Author:  Deddy Welsan
+
+    The --verify mode of the benchmark: runs every processor variant against
+    a plain overlap-add reference, so rewrites of the pipelines can be checked
+    before they are measured. Included by Main.cpp after the processors.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+/** What the verified processors do to every frame */
+enum class FrameOperation
+{
+    identity,
+    zero,
+    randomGain
+};
+
+static const char* getOperationName (FrameOperation operation)
+{
+    switch (operation)
+    {
+        case FrameOperation::identity:   return "identity";
+        case FrameOperation::zero:       return "zero";
+        case FrameOperation::randomGain: return "randomGain";
+    }
+
+    return "";
+}
+
+/** The gain of a frame, from the channel and the frame index only, so the reference can repeat it */
+static double getFrameGain (FrameOperation operation, int channel, int frameIndex)
+{
+    if (operation == FrameOperation::identity)
+        return 1.0;
+
+    if (operation == FrameOperation::zero)
+        return 0.0;
+
+    auto hash = (juce::uint32) (frameIndex * 7919 + channel * 104729) * 2654435761u;
+    hash ^= hash >> 15;
+    return 0.25 + 1.5 * (double) (hash & 0xffff) / 65535.0;
+}
+
+/** Counts the frames of every channel and scales them as the operation says */
+class FrameOperationState
+{
+public:
+    explicit FrameOperationState (FrameOperation operationToUse) : operation (operationToUse) {}
+
+    void prepare (int numChannels, int firstFrameIndex)
+    {
+        frameIndices.assign ((size_t) numChannels, firstFrameIndex);
+    }
+
+    /** Scales numValues values, stride apart, with the gain of the next frame of the channel */
+    template <typename FrameType>
+    void apply (int channel, FrameType* values, int numValues, int stride = 1)
+    {
+        const auto gain = (FrameType) getFrameGain (operation, channel, frameIndices[(size_t) channel]++);
+
+        for (int i = 0; i < numValues; ++i)
+            values[i * stride] *= gain;
+    }
+
+    /** Same as apply(), for the second array of a spectrum: uses the gain of the frame apply() has just scaled */
+    template <typename FrameType>
+    void applyAgain (int channel, FrameType* values, int numValues)
+    {
+        const auto gain = (FrameType) getFrameGain (operation, channel, frameIndices[(size_t) channel] - 1);
+        juce::FloatVectorOperations::multiply (values, gain, numValues);
+    }
+
+private:
+    const FrameOperation operation;
+    std::vector<int> frameIndices;
+};
+
+//==============================================================================
+/** The variants under verification behind one interface, see ProcessorUnderTest */
+template <typename SampleType>
+class VerificationTarget
+{
+public:
+    virtual ~VerificationTarget() = default;
+    virtual void prepare (double sampleRate, int blockSize, int numChannels) = 0;
+    virtual void process (juce::dsp::AudioBlock<SampleType>& block) = 0;
+    virtual int getLatencySamples() const = 0;
+
+    /**
+     The output with identity frames, for targets that do more than one overlap-add (the input delayed by their
+     latency, faded across a switch...), and the first sample where it is compared. The others return an empty
+     buffer and are compared with renderReference().
+     */
+    virtual juce::AudioBuffer<double> renderPassThrough (const juce::AudioBuffer<SampleType>& input, int& firstComparedSample) const
+    {
+        juce::ignoreUnused (input, firstComparedSample);
+        return {};
+    }
+};
+
+template <typename ProcessorType>
+class VerificationAdapter : public VerificationTarget<typename ProcessorType::SampleType>
+{
+public:
+    using SampleType = typename ProcessorType::SampleType;
+
+    explicit VerificationAdapter (std::unique_ptr<ProcessorType> processorToUse)
+        : processor (std::move (processorToUse))
+    {
+    }
+
+    void prepare (double sampleRate, int blockSize, int numChannels) override
+    {
+        processor->prepare (sampleRate, blockSize, numChannels, numChannels);
+    }
+
+    void process (juce::dsp::AudioBlock<SampleType>& block) override
+    {
+        processor->process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+    }
+
+    int getLatencySamples() const override { return processor->getLatencySamples(); }
+
+private:
+    std::unique_ptr<ProcessorType> processor;
+};
+
+//==============================================================================
+/** OverlapAddFftProcessor in any layout, scheduling and spectrum format, applying the operation where the frames are */
+template <typename Sample, typename Frame>
+class VerifiedOverlapAddProcessor : public BasicOverlapAddFftProcessor<Sample, Frame>
+{
+    using Base = BasicOverlapAddFftProcessor<Sample, Frame>;
+
+public:
+    using typename Base::FftBufferLayout;
+    using typename Base::SpectrumFormat;
+    using typename Base::SpectrumView;
+
+    VerifiedOverlapAddProcessor (int fftOrder, int hopDivider, FftWindowType windowType, FrameOperation operation)
+        : Base (fftOrder, hopDivider, windowType)
+        , frameOperation (operation)
+    {
+    }
+
+    ~VerifiedOverlapAddProcessor() override
+    {
+        this->stopFrameWorker();
+    }
+
+    void prepare (double sampleRate, int maximumBlockSize, int numInputChannels, int numOutputChannels)
+    {
+        Base::prepare (sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+        frameOperation.prepare (juce::jmax (numInputChannels, numOutputChannels), 0);
+    }
+
+    /** Applies the operation to the interleaved frames with FftBufferLayout::channelInterleaved. Calling
+        setFftBufferLayout() alone leaves it to processChannelFrame(), through the default processFrameInBuffer() */
+    void setLayout (FftBufferLayout newLayout)
+    {
+        layout = newLayout;
+        this->setFftBufferLayout (newLayout);
+    }
+
+protected:
+    void processFrameInBuffer (const int maxNumChannels) override
+    {
+        if (layout != FftBufferLayout::channelInterleaved)
+        {
+            Base::processFrameInBuffer (maxNumChannels);
+            return;
+        }
+
+        constexpr int lanes = Base::lanes;
+
+        for (int ch = 0; ch < maxNumChannels; ++ch)
+            frameOperation.apply (ch, this->getInterleavedFrames (ch / lanes) + ch % lanes, this->fftSize, lanes);
+    }
+
+    void processChannelFrame (const int ch) override
+    {
+        if (this->getSpectrumFormat() != SpectrumFormat::none)
+            Base::processChannelFrame (ch);
+        else
+            frameOperation.apply (ch, this->fftInOutBuffer.getWritePointer (ch), this->fftSize);
+    }
+
+    void processSpectrum (SpectrumView& spectrum) override
+    {
+        for (int ch = 0; ch < spectrum.getNumChannels(); ++ch)
+        {
+            const int channel = spectrum.getFirstChannel() + ch;
+
+            if (spectrum.getFormat() == SpectrumFormat::polar)
+            {
+                frameOperation.apply (channel, spectrum.getMagnitude (ch), spectrum.getNumBins());
+            }
+            else
+            {
+                frameOperation.apply (channel, spectrum.getReal (ch), spectrum.getNumBins());
+                frameOperation.applyAgain (channel, spectrum.getImag (ch), spectrum.getNumBins());
+            }
+        }
+    }
+
+private:
+    FrameOperationState frameOperation;
+    FftBufferLayout layout = FftBufferLayout::perChannel;
+};
+
+class VerifiedOverlappingProcessor final : public OverlappingFFTProcessorBase<VerifiedOverlappingProcessor, float>
+{
+public:
+    VerifiedOverlappingProcessor (int fftOrder, int hopDivider, FftWindowType windowType, FrameOperation operation)
+        : OverlappingFFTProcessorBase (fftOrder, hopDivider, windowType)
+        , frameOperation (operation)
+    {
+    }
+
+    void prepare (double sampleRate, int maximumBlockSize, int numInputChannels, int numOutputChannels)
+    {
+        OverlappingFFTProcessorBase::prepare (sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+
+        // the first frame is the first complete one, the ones reaching back before the start are skipped
+        frameOperation.prepare (juce::jmax (numInputChannels, numOutputChannels), fftSize / hopSize - 1);
+    }
+
+private:
+    friend OverlappingFFTProcessorBase;
+
+    void processChannelFrame (const int ch)
+    {
+        frameOperation.apply (ch, fftInOutBuffer.getWritePointer (ch), fftSize);
+    }
+
+    FrameOperationState frameOperation;
+};
+
+template <int FftOrder, int HopDivider>
+class VerifiedFixedProcessor final
+    : public FixedOverlapAddFftProcessorBase<VerifiedFixedProcessor<FftOrder, HopDivider>, FftOrder, HopDivider, maxFixedChannels>
+{
+    using Base = FixedOverlapAddFftProcessorBase<VerifiedFixedProcessor<FftOrder, HopDivider>, FftOrder, HopDivider, maxFixedChannels>;
+    friend Base;
+
+public:
+    VerifiedFixedProcessor (FftWindowType windowType, FrameOperation operation)
+        : Base (windowType)
+        , frameOperation (operation)
+    {
+    }
+
+    void prepare (double sampleRate, int maximumBlockSize, int numInputChannels, int numOutputChannels)
+    {
+        Base::prepare (sampleRate, maximumBlockSize, numInputChannels, numOutputChannels);
+        frameOperation.prepare (juce::jmax (numInputChannels, numOutputChannels), 0);
+    }
+
+private:
+    void processChannelFrame (const int ch)
+    {
+        frameOperation.apply (ch, this->fftInOutBuffer[(size_t) ch].data(), this->fftSize);
+    }
+
+    FrameOperationState frameOperation;
+};
+
+//==============================================================================
+/**
+ ReconfigurableFftProcessor switching from fftSize to 2 * fftSize at a fixed sample, whatever the block size, so
+ the fade through silence is checked sample by sample. The latency reported after rendering is the one after
+ the switch.
+ */
+class VerifiedReconfigurableTarget final : public VerificationTarget<float>
+{
+public:
+    VerifiedReconfigurableTarget (int fftOrder, int hopDivider)
+        : processor ({ { fftOrder, hopDivider }, { fftOrder + 1, hopDivider } })
+        , fftSize (1 << fftOrder)
+        , switchPosition (fftSize)
+        , crossfadeLength (fftSize / 2)
+    {
+        processor.setCrossfadeLength (crossfadeLength);
+    }
+
+    void prepare (double sampleRate, int blockSize, int numChannels) override
+    {
+        processor.prepare (sampleRate, blockSize, numChannels, numChannels);
+        position = 0;
+
+        for (int i = 0; i < 2; ++i)
+            latencies[i] = processor.getProcessor (i).getLatencySamples();
+    }
+
+    void process (juce::dsp::AudioBlock<float>& block) override
+    {
+        // the block is split where the switch starts
+        const auto numSamples = (int) block.getNumSamples();
+        const auto split = juce::jlimit (0, numSamples, switchPosition - position);
+
+        if (split > 0)
+        {
+            auto beforeSwitch = block.getSubBlock (0, (size_t) split);
+            processor.process (juce::dsp::ProcessContextReplacing<float> (beforeSwitch));
+        }
+
+        if (split < numSamples)
+        {
+            processor.setConfiguration (1);
+            auto afterSwitch = block.getSubBlock ((size_t) split, (size_t) (numSamples - split));
+            processor.process (juce::dsp::ProcessContextReplacing<float> (afterSwitch));
+        }
+
+        position += numSamples;
+    }
+
+    int getLatencySamples() const override { return processor.getLatencySamples(); }
+
+    juce::AudioBuffer<double> renderPassThrough (const juce::AudioBuffer<float>& input, int& firstComparedSample) const override
+    {
+        // the first output fades out until the second one is valid, then that one fades in
+        const int silenceStart = juce::jmax (latencies[1], crossfadeLength);
+        juce::AudioBuffer<double> expected (input.getNumChannels(), input.getNumSamples());
+
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+        {
+            const auto* x = input.getReadPointer (ch);
+            auto* y = expected.getWritePointer (ch);
+
+            for (int n = 0; n < input.getNumSamples(); ++n)
+            {
+                const int sinceSwitch = n - switchPosition;
+                const auto fadeOut = sinceSwitch < 0 ? 1.0 : juce::jlimit (0.0, 1.0, (double) (silenceStart - sinceSwitch) / crossfadeLength);
+                const auto fadeIn = sinceSwitch < 0 ? 0.0 : juce::jlimit (0.0, 1.0, (double) (sinceSwitch + 1 - silenceStart) / crossfadeLength);
+
+                y[n] = (n >= latencies[0] ? fadeOut * x[n - latencies[0]] : 0.0)
+                     + (n >= latencies[1] ? fadeIn * x[n - latencies[1]] : 0.0);
+            }
+        }
+
+        // the first frames of the first configuration fill up
+        firstComparedSample = latencies[0] + fftSize;
+        return expected;
+    }
+
+private:
+    ReconfigurableFftProcessor<OverlapAddFftProcessor> processor;
+    const int fftSize;
+    const int switchPosition;
+    const int crossfadeLength;
+    int latencies[2] {};
+    int position = 0;
+};
+
+/** MultiResolutionFftProcessor with a band of fftSize at a quarter of the sample rate below 3 kHz, and one above */
+class VerifiedMultiResolutionTarget final : public VerificationTarget<float>
+{
+public:
+    VerifiedMultiResolutionTarget (int fftOrder, int hopDivider)
+        : processor ({ { fftOrder, hopDivider, 2 }, { fftOrder, hopDivider, 0 } }, { 3000.0f })
+    {
+    }
+
+    void prepare (double sampleRate, int blockSize, int numChannels) override
+    {
+        processor.prepare (sampleRate, blockSize, numChannels, numChannels);
+    }
+
+    void process (juce::dsp::AudioBlock<float>& block) override
+    {
+        processor.process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+
+    int getLatencySamples() const override { return processor.getLatencySamples(); }
+
+    juce::AudioBuffer<double> renderPassThrough (const juce::AudioBuffer<float>& input, int& firstComparedSample) const override
+    {
+        const int latency = processor.getLatencySamples();
+        juce::AudioBuffer<double> expected (input.getNumChannels(), input.getNumSamples());
+        expected.clear();
+
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            for (int n = latency; n < input.getNumSamples(); ++n)
+                expected.setSample (ch, n, (double) input.getSample (ch, n - latency));
+
+        // the frames of the low band, which make up most of the latency, fill up
+        firstComparedSample = 2 * latency;
+        return expected;
+    }
+
+private:
+    MultiResolutionFftProcessor<OverlapAddFftProcessor> processor;
+};
+
+//==============================================================================
+/** One variant: how to build it, and what the reference needs to know about it */
+struct VerificationVariant
+{
+    juce::String name;
+    bool usesDouble = false;
+    bool fixedOrdersOnly = false;
+    bool lowLatency = false;
+};
+
+static const std::vector<VerificationVariant> verificationVariants {
+    { "OverlapAddFftProcessor" },
+    { "OverlapAddFftProcessor/workerThread" },
+    { "OverlapAddFftProcessor/loadBalanced" },
+    { "OverlapAddFftProcessor/channelInterleaved" },
+    { "OverlapAddFftProcessor/channelInterleaved/channelFrame" },
+    { "OverlapAddFftProcessor/channelThreads" },
+    { "OverlapAddFftProcessor/cartesian" },
+    { "OverlapAddFftProcessor/polar" },
+    { "OverlapAddFftProcessor/subFrame", false, false, true },
+    { "DoubleOverlapAddFftProcessor", true },
+    { "MixedOverlapAddFftProcessor", true },
+    { "OverlappingFFTProcessor" },
+    { "OverlappingFFTProcessor/channelThreads" },
+    { "FixedOverlapAddFftProcessor", false, true },
+    { "ReconfigurableFftProcessor" },
+    { "MultiResolutionFftProcessor" }
+};
+
+/** One point of the sweep */
+struct VerificationCase
+{
+    VerificationVariant variant;
+    int fftOrder = 10;
+    int hopDivider = 2;
+    FftWindowType windowType = FftWindowType::hann;
+    FrameOperation operation = FrameOperation::identity;
+    int numChannels = 2;
+
+    int getFftSize() const { return 1 << fftOrder; }
+    int getHopSize() const { return getFftSize() >> hopDivider; }
+
+    /** The synthesised part of a frame, see OverlapAddFftProcessorBase::setSubFrameSize() */
+    int getSubFrameSize() const { return variant.lowLatency ? juce::jmin (getFftSize(), 2 * getHopSize()) : getFftSize(); }
+
+    juce::String getName() const
+    {
+        static const char* windowNames[] = { "hann", "hamming", "blackmanHarris", "sqrtHann", "kaiser" };
+
+        return variant.name + "/fft:" + juce::String (getFftSize()) + "/hop:" + juce::String (getHopSize())
+                 + "/" + windowNames[(int) windowType] + "/" + getOperationName (operation) + "/ch:" + juce::String (numChannels);
+    }
+};
+
+template <int FftOrder, int HopDivider>
+static std::unique_ptr<VerificationTarget<float>> createFixedTarget (const VerificationCase& c)
+{
+    return std::make_unique<VerificationAdapter<VerifiedFixedProcessor<FftOrder, HopDivider>>> (
+               std::make_unique<VerifiedFixedProcessor<FftOrder, HopDivider>> (c.windowType, c.operation));
+}
+
+/** The orders and dividers FixedOverlapAddFftProcessor is instantiated for here */
+static std::unique_ptr<VerificationTarget<float>> createFixedTargetFor (const VerificationCase& c)
+{
+    switch (c.fftOrder * 10 + c.hopDivider)
+    {
+        case 81:  return createFixedTarget<8, 1> (c);
+        case 82:  return createFixedTarget<8, 2> (c);
+        case 83:  return createFixedTarget<8, 3> (c);
+        case 101: return createFixedTarget<10, 1> (c);
+        case 102: return createFixedTarget<10, 2> (c);
+        case 103: return createFixedTarget<10, 3> (c);
+        default:  return nullptr;
+    }
+}
+
+template <typename Sample, typename Frame>
+static std::unique_ptr<VerificationTarget<Sample>> createOverlapAddTarget (const VerificationCase& c)
+{
+    using ProcessorType = VerifiedOverlapAddProcessor<Sample, Frame>;
+
+    auto processor = std::make_unique<ProcessorType> (c.fftOrder, c.hopDivider, c.windowType, c.operation);
+    const auto& name = c.variant.name;
+
+    if (name.endsWith ("/workerThread"))        processor->setFrameScheduling (ProcessorType::FrameScheduling::workerThread);
+    if (name.endsWith ("/loadBalanced"))        processor->setFrameScheduling (ProcessorType::FrameScheduling::loadBalanced);
+    if (name.endsWith ("/channelInterleaved"))  processor->setLayout (ProcessorType::FftBufferLayout::channelInterleaved);
+    if (name.endsWith ("/channelFrame"))        processor->setFftBufferLayout (ProcessorType::FftBufferLayout::channelInterleaved);
+    if (name.endsWith ("/channelThreads"))      processor->setParallelChannelProcessing (3, 2);
+    if (name.endsWith ("/cartesian"))           processor->setSpectrumFormat (ProcessorType::SpectrumFormat::cartesian);
+    if (name.endsWith ("/polar"))               processor->setSpectrumFormat (ProcessorType::SpectrumFormat::polar);
+    if (c.variant.lowLatency)                   processor->setSubFrameSize (c.getSubFrameSize());
+
+    return std::make_unique<VerificationAdapter<ProcessorType>> (std::move (processor));
+}
+
+static std::unique_ptr<VerificationTarget<float>> createFloatTarget (const VerificationCase& c)
+{
+    const auto& name = c.variant.name;
+
+    if (name.startsWith ("OverlapAddFftProcessor"))
+        return createOverlapAddTarget<float, float> (c);
+
+    if (name.startsWith ("OverlappingFFTProcessor"))
+    {
+        auto processor = std::make_unique<VerifiedOverlappingProcessor> (c.fftOrder, c.hopDivider, c.windowType, c.operation);
+        if (name.endsWith ("/channelThreads"))
+            processor->setParallelChannelProcessing (3, 2);
+
+        return std::make_unique<VerificationAdapter<VerifiedOverlappingProcessor>> (std::move (processor));
+    }
+
+    if (name == "FixedOverlapAddFftProcessor" && c.numChannels <= maxFixedChannels)
+        return createFixedTargetFor (c);
+
+    // the processors made of several overlap-adds are only checked for pass-through
+    if (name == "ReconfigurableFftProcessor" && c.operation == FrameOperation::identity)
+        return std::make_unique<VerifiedReconfigurableTarget> (c.fftOrder, c.hopDivider);
+
+    if (name == "MultiResolutionFftProcessor" && c.operation == FrameOperation::identity)
+        return std::make_unique<VerifiedMultiResolutionTarget> (c.fftOrder, c.hopDivider);
+
+    return nullptr;
+}
+
+static std::unique_ptr<VerificationTarget<double>> createDoubleTarget (const VerificationCase& c)
+{
+    if (c.variant.name == "DoubleOverlapAddFftProcessor")
+        return createOverlapAddTarget<double, double> (c);
+
+    if (c.variant.name == "MixedOverlapAddFftProcessor")
+        return createOverlapAddTarget<double, float> (c);
+
+    return nullptr;
+}
+
+static std::unique_ptr<VerificationTarget<float>> createTarget (const VerificationCase& c, float)   { return createFloatTarget (c); }
+static std::unique_ptr<VerificationTarget<double>> createTarget (const VerificationCase& c, double) { return createDoubleTarget (c); }
+
+//==============================================================================
+/** What a case found. Errors are relative to the peak of the input */
+struct VerificationResult
+{
+    double maxError = 0.0;
+    double maxBlockSizeDeviation = 0.0;
+    bool bitExactAcrossBlockSizes = true;
+    int reportedLatency = 0;
+    int measuredLatency = -1;
+    double maxCrosstalk = 0.0;
+    bool failed = false;
+    juce::String failure;
+};
+
+/**
+ The plain weighted overlap-add every variant has to reproduce, in double precision: frame k ends with input
+ sample (k + 1) * hopSize - 1, its input before sample 0 is silence, and each sample of the frame goes to the
+ output latency samples after its input. There's no FFT, the operations are gains, which the transforms don't change.
+ */
+template <typename SampleType>
+static juce::AudioBuffer<double> renderReference (const VerificationCase& c, const juce::AudioBuffer<SampleType>& input, int latency)
+{
+    const int fftSize = c.getFftSize();
+    const int hopSize = c.getHopSize();
+    const int length = input.getNumSamples();
+
+    FftWindow<double> window;
+    if (c.getSubFrameSize() < fftSize)
+        window.createLowLatency (fftSize, hopSize, c.getSubFrameSize());
+    else
+        window.create (c.windowType, fftSize, hopSize);
+
+    juce::AudioBuffer<double> output (input.getNumChannels(), length);
+    output.clear();
+
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+    {
+        const auto* x = input.getReadPointer (ch);
+        auto* y = output.getWritePointer (ch);
+
+        for (int frame = 0; (frame + 1) * hopSize - 1 < length; ++frame)
+        {
+            const auto gain = getFrameGain (c.operation, ch, frame);
+            const int frameStart = (frame + 1) * hopSize - fftSize;
+
+            for (int n = 0; n < fftSize; ++n)
+            {
+                const int s = frameStart + n;
+                if (s >= 0 && s + latency < length)
+                    y[s + latency] += gain * (double) x[s] * window.getAnalysisWindow()[n] * window.getSynthesisWindow()[n];
+            }
+        }
+    }
+
+    return output;
+}
+
+/** Processes the input in blocks of blockSize with a freshly prepared target, in place */
+template <typename SampleType>
+static void renderTarget (VerificationTarget<SampleType>& target, juce::AudioBuffer<SampleType>& buffer, int blockSize)
+{
+    target.prepare (48000.0, blockSize, buffer.getNumChannels());
+
+    for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+    {
+        auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubBlock ((size_t) start, (size_t) juce::jmin (blockSize, buffer.getNumSamples() - start));
+        target.process (block);
+    }
+}
+
+/**
+ Runs one case at all block sizes:
+ - the output has to match the reference within the tolerance of the precision, once the first complete frame
+   reaches it (OverlappingFFTProcessor skips the frames reaching back before the start). Targets made of several
+   overlap-adds render their own, see VerificationTarget::renderPassThrough()
+ - the output must not depend on the block size, and is reported as bit-exact or not
+ - with identity frames, an impulse has to come out after the reported latency
+ - a signal on channel 0 only must leave the other channels silent
+ */
+template <typename SampleType>
+static bool verifyCase (const VerificationCase& c, const juce::Array<int>& blockSizes, VerificationResult& result)
+{
+    if (createTarget (c, SampleType()) == nullptr)
+        return false;
+
+    const int fftSize = c.getFftSize();
+    const int length = 12 * fftSize + 321;
+    const double tolerance = std::is_same<SampleType, double>::value && c.variant.name != "MixedOverlapAddFftProcessor" ? 1.0e-12 : 1.0e-5;
+
+    juce::AudioBuffer<SampleType> input (c.numChannels, length);
+    juce::Random random (c.fftOrder * 100 + c.hopDivider * 10 + c.numChannels);
+
+    for (int ch = 0; ch < c.numChannels; ++ch)
+        for (int i = 0; i < length; ++i)
+            input.setSample (ch, i, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+
+    juce::AudioBuffer<SampleType> firstOutput;
+
+    for (auto blockSize : blockSizes)
+    {
+        auto target = createTarget (c, SampleType());
+        juce::AudioBuffer<SampleType> output (input);
+        renderTarget (*target, output, blockSize);
+
+        result.reportedLatency = target->getLatencySamples();
+        int firstComparedSample = result.reportedLatency + fftSize;
+        auto reference = target->renderPassThrough (input, firstComparedSample);
+        if (reference.getNumSamples() == 0)
+            reference = renderReference (c, input, result.reportedLatency);
+
+        for (int ch = 0; ch < c.numChannels; ++ch)
+            for (int i = firstComparedSample; i < length; ++i)
+                result.maxError = juce::jmax (result.maxError, std::abs ((double) output.getSample (ch, i) - reference.getSample (ch, i)));
+
+        if (firstOutput.getNumSamples() == 0)
+        {
+            firstOutput.makeCopyOf (output);
+            continue;
+        }
+
+        for (int ch = 0; ch < c.numChannels; ++ch)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                const auto deviation = std::abs ((double) output.getSample (ch, i) - (double) firstOutput.getSample (ch, i));
+                result.maxBlockSizeDeviation = juce::jmax (result.maxBlockSizeDeviation, deviation);
+                result.bitExactAcrossBlockSizes = result.bitExactAcrossBlockSizes && output.getSample (ch, i) == firstOutput.getSample (ch, i);
+            }
+        }
+    }
+
+    if (c.operation == FrameOperation::identity)
+    {
+        const int impulsePosition = 3 * fftSize + 17;
+        juce::AudioBuffer<SampleType> impulse (c.numChannels, length);
+        impulse.clear();
+
+        for (int ch = 0; ch < c.numChannels; ++ch)
+            impulse.setSample (ch, impulsePosition, (SampleType) 1);
+
+        auto target = createTarget (c, SampleType());
+        renderTarget (*target, impulse, 441);
+
+        int peakPosition = 0;
+        for (int i = 1; i < length; ++i)
+            if (std::abs (impulse.getSample (0, i)) > std::abs (impulse.getSample (0, peakPosition)))
+                peakPosition = i;
+
+        result.measuredLatency = peakPosition - impulsePosition;
+    }
+
+    if (c.numChannels > 1)
+    {
+        juce::AudioBuffer<SampleType> isolated (input);
+        for (int ch = 1; ch < c.numChannels; ++ch)
+            isolated.clear (ch, 0, length);
+
+        auto target = createTarget (c, SampleType());
+        renderTarget (*target, isolated, 441);
+
+        for (int ch = 1; ch < c.numChannels; ++ch)
+            for (int i = 0; i < length; ++i)
+                result.maxCrosstalk = juce::jmax (result.maxCrosstalk, std::abs ((double) isolated.getSample (ch, i)));
+    }
+
+    // the input peaks at 1, so the errors are relative to it
+    if (result.maxError > tolerance)
+        result.failure << "error " << juce::String (result.maxError, 2, true) << " ";
+    if (result.maxBlockSizeDeviation > tolerance)
+        result.failure << "block size dependent " << juce::String (result.maxBlockSizeDeviation, 2, true) << " ";
+    if (result.measuredLatency >= 0 && result.measuredLatency != result.reportedLatency)
+        result.failure << "latency " << result.measuredLatency << " instead of " << result.reportedLatency << " ";
+    if (result.maxCrosstalk > 0.0)
+        result.failure << "crosstalk " << juce::String (result.maxCrosstalk, 2, true) << " ";
+
+    result.failed = result.failure.isNotEmpty();
+    return true;
+}
+
+//==============================================================================
+/** The sweep of --verify, parsed from the command line */
+struct VerificationSettings
+{
+    juce::Array<int> fftOrders { 8, 10 };
+    juce::Array<int> hopDividers { 1, 2, 3 };
+    juce::Array<int> channelCounts { 1, 2, 5 };
+    juce::Array<int> blockSizes { 1, 7, 64, 441, 512, 4096 };
+    juce::StringArray filters;
+    bool requireBitExact = false;
+};
+
+/**
+ Runs every variant with every operation over the sweep, and prints one line per case.
+ All windows are checked with OverlapAddFftProcessor, the other variants use the Hann window.
+ @returns the number of failed cases
+ */
+static int runVerification (const VerificationSettings& settings)
+{
+    int numCases = 0;
+    int numFailed = 0;
+
+    for (const auto& variant : verificationVariants)
+        for (auto order : settings.fftOrders)
+            for (auto hopDivider : settings.hopDividers)
+                for (int windowIndex = 0; windowIndex <= (int) FftWindowType::kaiser; ++windowIndex)
+                    for (auto operation : { FrameOperation::identity, FrameOperation::zero, FrameOperation::randomGain })
+                        for (auto numChannels : settings.channelCounts)
+                        {
+                            const auto windowType = (FftWindowType) windowIndex;
+                            if (windowType != FftWindowType::hann && (variant.name != "OverlapAddFftProcessor" || variant.lowLatency))
+                                continue;
+
+                            const VerificationCase c { variant, order, hopDivider, windowType, operation, numChannels };
+                            if (hopDivider < 1 || hopDivider > order || ! matchesFilters (c.getName(), settings.filters))
+                                continue;
+
+                            VerificationResult result;
+                            const auto ran = variant.usesDouble ? verifyCase<double> (c, settings.blockSizes, result)
+                                                                : verifyCase<float> (c, settings.blockSizes, result);
+                            if (! ran)
+                                continue;
+
+                            if (settings.requireBitExact && ! result.bitExactAcrossBlockSizes)
+                            {
+                                result.failure << "not bit-exact across block sizes ";
+                                result.failed = true;
+                            }
+
+                            ++numCases;
+                            if (result.failed)
+                                ++numFailed;
+
+                            std::cout << (result.failed ? "FAIL " : "ok   ") << c.getName().paddedRight (' ', 84)
+                                      << " error " << juce::String (result.maxError, 2, true).paddedLeft (' ', 9)
+                                      << (result.bitExactAcrossBlockSizes ? "  bit-exact" : "  rounding ")
+                                      << "  latency " << result.reportedLatency;
+
+                            if (result.failed)
+                                std::cout << "  " << result.failure.trim();
+
+                            std::cout << std::endl;
+                        }
+
+    std::cout << numCases - numFailed << " of " << numCases << " cases passed" << std::endl;
+    return numFailed;
+}